@@ -0,0 +1,313 @@
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <numeric>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "command_line.hpp"
+#include "hello_triangle_application.hpp"
+#include "utilities.hpp"
+
+namespace {
+
+using Milliseconds = std::chrono::duration<double, std::milli>;
+using Application  = vt::triangle::HelloTriangleApplication;
+
+struct BenchSettings {
+    Application::Settings app        = {};
+    uint64_t              frames     = 0;  // Measured frames, 0 means use 'seconds' instead.
+    double                seconds    = 0.0;
+    uint64_t              warmup     = 100;
+    uint64_t              resizeStep = 0;   // Resize the window every N frames to stress swap chain recreation, 0 disables.
+    std::string           outputPath = {};  // Empty writes the report to stdout.
+};
+
+// Samples of a single measured quantity in milliseconds.
+class Series {
+  public:
+    void Add(std::chrono::nanoseconds sample) { m_samples.push_back(Milliseconds(sample).count()); }
+
+    [[nodiscard]] auto Count() const -> size_t { return m_samples.size(); }
+
+    [[nodiscard]] auto ToJson() const -> std::string {
+        if (m_samples.empty()) {
+            return R"({ "mean": 0, "p50": 0, "p95": 0, "p99": 0, "max": 0 })";
+        }
+
+        std::vector<double> sorted = m_samples;
+        std::ranges::sort(sorted);
+
+        const double mean = std::accumulate(sorted.begin(), sorted.end(), 0.0) / static_cast<double>(sorted.size());
+        return std::format(R"({{ "mean": {:.4f}, "p50": {:.4f}, "p95": {:.4f}, "p99": {:.4f}, "max": {:.4f} }})", mean, Percentile(sorted, 50.0),
+                           Percentile(sorted, 95.0), Percentile(sorted, 99.0), sorted.back());
+    }
+
+  private:
+    std::vector<double> m_samples;
+
+    // Nearest-rank percentile of an already sorted, non-empty series.
+    static auto Percentile(const std::vector<double>& sorted, double percentile) -> double {
+        const auto rank = static_cast<size_t>(std::ceil(percentile / 100.0 * static_cast<double>(sorted.size())));
+        return sorted[std::clamp<size_t>(rank, 1, sorted.size()) - 1];
+    }
+};
+
+auto ParseArguments(std::span<char*> args) -> BenchSettings {
+    BenchSettings settings = {};
+
+    for (size_t i = 1; i < args.size(); i++) {
+        const std::string_view arg = args[i];
+
+        if (arg == "--seconds") {
+            settings.seconds = std::stod(vt::cli::NextValue(args, i));
+        } else if (arg == "--warmup") {
+            settings.warmup = std::stoull(vt::cli::NextValue(args, i));
+        } else if (arg == "--resize-stress") {
+            settings.resizeStep = std::stoull(vt::cli::NextValue(args, i));
+        } else if (arg == "--output") {
+            settings.outputPath = vt::cli::NextValue(args, i);
+        } else if (!vt::cli::ParseSettingsOption(args, i, settings.app)) {
+            throw std::invalid_argument(std::format("Unknown option [{}].", arg));
+        }
+    }
+
+    // '--frames' is shared with the application, here it selects the number of measured frames.
+    settings.frames = settings.app.maxFrames;
+    if (0 == settings.frames && settings.seconds <= 0.0) {
+        settings.frames = 1000;
+    }
+
+    if (0 != settings.resizeStep && settings.app.headless) {
+        throw std::invalid_argument("--resize-stress requires a window, it can't be combined with --headless.");
+    }
+
+    // Captured frames streamed to stdout would be interleaved with the report.
+    if (settings.app.capturePath == "-" && settings.outputPath.empty()) {
+        throw std::invalid_argument("--capture - writes the frames to stdout, it requires --output for the report.");
+    }
+
+    return settings;
+}
+
+auto RunBenchmark(const BenchSettings& settings) -> std::string {
+    using Clock = std::chrono::steady_clock;
+
+    Application app(settings.app);
+
+    const auto initStart = Clock::now();
+    app.Initialize();
+    const auto initDone = Clock::now();
+
+    // Startup only ends once the first frame has been submitted and presented, which is what a freshly started instance waits for.
+    app.PollEvents();
+    app.DrawFrame();
+    const auto firstFrameDone = Clock::now();
+
+    const auto pipelineStats    = app.GetPipelineStats();
+    const bool dynamicRendering = app.UsesDynamicRendering();
+
+    std::string startupReport;
+    for (const auto& step : app.GetStartupTimeline()) {
+        startupReport += std::format(R"({}{{ "name": "{}", "startMs": {:.3f}, "durationMs": {:.3f}, "thread": {} }})", startupReport.empty() ? "" : ", ", step.name,
+                                     Milliseconds(step.begin - initStart).count(), Milliseconds(step.end - step.begin).count(), step.thread);
+    }
+
+    for (uint64_t i = 0; i < settings.warmup && app.PollEvents(); i++) {
+        app.DrawFrame();
+    }
+
+    Series frameWait;
+    Series upload;
+    Series acquire;
+    Series record;
+    Series submit;
+    Series present;
+    Series frameTime;
+    Series inputToPresent;
+    Series recreate;
+    Series recreateFrameTime;  // Frame time of only the frames that recreated the swap chain.
+
+    // Frames the GPU is behind the CPU right after each submit, read from the frame timeline semaphore.
+    uint64_t gpuFramesBehindSum = 0;
+    uint64_t gpuFramesBehindMax = 0;
+
+    // GPU time per region, only filled with '--gpu-stats'. A region gains one sample per frame once its timestamps are read back.
+    std::vector<std::pair<std::string, Series>> gpuRegions;
+    std::vector<uint64_t>                       gpuRegionSamples;
+
+    // A scripted sequence of window sizes, cycled through by the resize stress test.
+    static constexpr std::array<std::array<int32_t, 2>, 4> kResizeSizes = { { { 1024, 768 }, { 640, 480 }, { 1280, 720 }, { 800, 600 } } };
+
+    // The frame time is measured between consecutive frame starts, so that it includes event polling.
+    uint64_t   frames     = 0;
+    const auto loopStart  = Clock::now();
+    auto       frameStart = loopStart;
+    const auto limit      = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(settings.seconds));
+
+    while (app.PollEvents()) {
+        if (0 != settings.frames ? frames >= settings.frames : Clock::now() - loopStart >= limit) {
+            break;
+        }
+
+        if (0 != settings.resizeStep && 0 == (frames + 1) % settings.resizeStep) {
+            const auto& size = kResizeSizes.at((frames / settings.resizeStep) % kResizeSizes.size());
+            app.SetWindowSize(size[0], size[1]);
+        }
+
+        app.DrawFrame();
+
+        const auto  frameEnd = Clock::now();
+        const auto& timings  = app.GetLastFrameTimings();
+        frameWait.Add(timings.frameWait);
+        upload.Add(timings.upload);
+        acquire.Add(timings.acquire);
+        record.Add(timings.record);
+        submit.Add(timings.submit);
+        present.Add(timings.present);
+        frameTime.Add(frameEnd - frameStart);
+        inputToPresent.Add(timings.inputToPresent);
+
+        const uint64_t gpuFramesBehind = app.GetSubmittedFrameCount() - app.GetCompletedFrameCount();
+        gpuFramesBehindSum += gpuFramesBehind;
+        gpuFramesBehindMax  = std::max(gpuFramesBehindMax, gpuFramesBehind);
+
+        const auto gpuStats = app.GetGpuStats();
+        gpuRegions.resize(gpuStats.size());
+        gpuRegionSamples.resize(gpuStats.size());
+        for (size_t region = 0; region < gpuStats.size(); region++) {
+            gpuRegions[region].first = gpuStats[region].name;
+            if (gpuStats[region].samples != gpuRegionSamples[region]) {
+                gpuRegions[region].second.Add(std::chrono::duration_cast<std::chrono::nanoseconds>(Milliseconds(gpuStats[region].lastMs)));
+                gpuRegionSamples[region] = gpuStats[region].samples;
+            }
+        }
+
+        if (timings.recreate.count() > 0) {
+            recreate.Add(timings.recreate);
+            recreateFrameTime.Add(frameEnd - frameStart);
+        }
+
+        frameStart = frameEnd;
+        frames++;
+    }
+
+    app.WaitIdle();
+    const std::chrono::duration<double> elapsed           = Clock::now() - loopStart;
+    const auto                          memoryStats       = app.GetMemoryStats();
+    const uint64_t                      trianglesPerFrame = app.GetTrianglesPerFrame();
+    const auto                          uploadStats       = app.GetUploadStats();
+    const auto                          presentMode       = app.GetPresentMode();
+    const uint32_t                      swapImageCount    = app.GetSwapchainImageCount();
+    const auto                          variantStats      = app.GetPipelineVariantStats();
+    const uint64_t                      fallbackFrames    = app.GetFallbackFrameCount();
+    const auto                          captureStats      = app.GetCaptureStats();
+    const auto                          overdrawStats     = app.GetOverdrawStats();
+    const bool                          depthBuffer       = app.UsesDepthBuffer();
+    app.Cleanup();
+
+    const double meanFps             = elapsed.count() > 0.0 ? static_cast<double>(frames) / elapsed.count() : 0.0;
+    const double meanGpuFramesBehind = frames > 0 ? static_cast<double>(gpuFramesBehindSum) / static_cast<double>(frames) : 0.0;
+
+    // Submitted triangles, including the ones culled or clipped, so that sweeps compare the geometry load as well as the pixel load.
+    const double triangles          = static_cast<double>(frames) * static_cast<double>(trianglesPerFrame);
+    const double trianglesPerSecond = elapsed.count() > 0.0 ? triangles / elapsed.count() : 0.0;
+
+    std::string gpuReport;
+    for (const auto& [name, series] : gpuRegions) {
+        gpuReport += std::format(R"({}"{}": {})", gpuReport.empty() ? "" : ", ", name, series.ToJson());
+    }
+
+    std::string report = "{\n";
+    report += std::format(R"(  "settings": {{ "headless": {}, "framesInFlight": {}, "staticScene": {}, "draws": {}, "instances": {}, "instanceScale": {}, )"
+                          R"("animate": {}, "blend": {}, "cullMode": "{}", "culling": "{}", "viewZoom": {}, "recordThreads": {}, "gpuStats": {}, "transferQueue": {}, )"
+                          R"("uploadStreamKiB": {}, "presentPolicy": "{}", "initThreads": {}, "colorMode": "{}", "colorModeCycle": {}, "warmupFrames": {} }},)" "\n",
+                          settings.app.headless, settings.app.framesInFlight, settings.app.staticScene, settings.app.drawCount, settings.app.instanceCount,
+                          settings.app.instanceScale, settings.app.animateInstances, settings.app.blend, vt::cli::CullModeName(settings.app.cullMode),
+                          vt::cli::CullingModeName(settings.app.culling), settings.app.viewZoom, settings.app.recordThreads,
+                          settings.app.gpuStats, settings.app.transferQueue, settings.app.uploadStreamKiB,
+                          vt::cli::PresentPolicyName(settings.app.presentPolicy), settings.app.initThreads, vt::cli::ColorModeName(settings.app.colorMode),
+                          settings.app.colorModeCycle, settings.warmup);
+    report += std::format(R"(  "initMs": {:.3f},)" "\n", Milliseconds(initDone - initStart).count());
+    report += std::format(R"(  "firstFrameMs": {:.3f},)" "\n", Milliseconds(firstFrameDone - initStart).count());
+    report += std::format(R"(  "startup": [ {} ],)" "\n", startupReport);
+    report += std::format(R"(  "pipeline": {{ "cacheWarm": {}, "createMs": {:.3f}, "dynamicRendering": {} }},)" "\n", pipelineStats.cacheWarm,
+                          Milliseconds(pipelineStats.createTime).count(), dynamicRendering);
+    report += std::format(R"(  "pipelineVariants": {{ "compiled": {}, "failed": {}, "maxCompileMs": {:.3f}, "fallbackFrames": {} }},)" "\n", variantStats.compiled,
+                          variantStats.failed, Milliseconds(variantStats.maxCompileTime).count(), fallbackFrames);
+    report += std::format(R"(  "frames": {},)" "\n", frames);
+    report += std::format(R"(  "durationSeconds": {:.3f},)" "\n", elapsed.count());
+    report += std::format(R"(  "meanFps": {:.2f},)" "\n", meanFps);
+    report += std::format(R"(  "trianglesPerSecond": {:.0f},)" "\n", trianglesPerSecond);
+    report += std::format(R"(  "frameTimeMs": {},)" "\n", frameTime.ToJson());
+    report += std::format(R"(  "frameWaitMs": {},)" "\n", frameWait.ToJson());
+    report += std::format(R"(  "uploadMs": {},)" "\n", upload.ToJson());
+    report += std::format(R"(  "acquireMs": {},)" "\n", acquire.ToJson());
+    report += std::format(R"(  "recordMs": {},)" "\n", record.ToJson());
+    report += std::format(R"(  "submitMs": {},)" "\n", submit.ToJson());
+    report += std::format(R"(  "presentMs": {},)" "\n", present.ToJson());
+    report += std::format(R"(  "present": {{ "mode": "{}", "swapchainImages": {} }},)" "\n", settings.app.headless ? "none" : vt::utilities::PresentModeName(presentMode),
+                          swapImageCount);
+    report += std::format(R"(  "inputToPresentMs": {},)" "\n", inputToPresent.ToJson());
+    report += std::format(R"(  "gpuFramesBehind": {{ "mean": {:.2f}, "max": {} }},)" "\n", meanGpuFramesBehind, gpuFramesBehindMax);
+    report += std::format(R"(  "gpuMs": {{ {} }},)" "\n", gpuReport);
+    report += std::format(R"(  "overdraw": {{ "depthBuffer": {}, "drawOrder": "{}", "frames": {}, "fragmentsPerFrame": {:.0f}, "mean": {:.3f}, "max": {:.3f} }},)" "\n",
+                          depthBuffer, vt::cli::DrawOrderName(settings.app.drawOrder), overdrawStats.frames, overdrawStats.MeanInvocations(),
+                          overdrawStats.MeanOverdraw(), overdrawStats.maxOverdraw);
+    report += std::format(R"(  "memory": {{ "deviceAllocations": {}, "allocations": {}, "blockBytes": {}, "usedBytes": {}, "fragmentation": {:.4f} }},)" "\n",
+                          memoryStats.deviceAllocationCount, memoryStats.allocationCount, memoryStats.blockBytes, memoryStats.usedBytes,
+                          memoryStats.Fragmentation());
+    report += std::format(R"(  "upload": {{ "dedicatedQueue": {}, "bytes": {}, "submissions": {}, "ringStalls": {} }},)" "\n", uploadStats.dedicatedQueue,
+                          uploadStats.uploadedBytes, uploadStats.submissions, uploadStats.ringStalls);
+    report += std::format(R"(  "capture": {{ "format": "{}", "buffers": {}, "captured": {}, "written": {}, "dropped": {}, "failed": {}, "bytes": {}, )"
+                          R"("maxWriteMs": {:.3f} }},)" "\n",
+                          vt::cli::CaptureFormatName(settings.app.captureFormat), settings.app.captureBuffers, captureStats.captured, captureStats.written,
+                          captureStats.dropped, captureStats.failed, captureStats.writtenBytes, Milliseconds(captureStats.maxWriteTime).count());
+    report += std::format(R"(  "swapchainRecreations": {},)" "\n", recreate.Count());
+    report += std::format(R"(  "recreateMs": {},)" "\n", recreate.ToJson());
+    report += std::format(R"(  "recreateFrameTimeMs": {})" "\n", recreateFrameTime.ToJson());
+    report += "}\n";
+
+    return report;
+}
+
+}  // namespace
+
+auto main(int argc, char* argv[]) -> int {
+    // Keep stdout for the report only, the application logs to std::cout as well.
+    std::streambuf* stdoutBuffer = std::cout.rdbuf(std::cerr.rdbuf());
+
+    try {
+        const BenchSettings settings = ParseArguments({ argv, static_cast<size_t>(argc) });
+        const std::string   report   = RunBenchmark(settings);
+
+        std::cout.rdbuf(stdoutBuffer);
+
+        if (settings.outputPath.empty()) {
+            std::cout << report;
+        } else {
+            std::ofstream file(settings.outputPath, std::ios::trunc);
+            if (!file.is_open()) {
+                throw std::runtime_error(std::format("Failed to open output file: [{}].", settings.outputPath));
+            }
+            file << report;
+        }
+    } catch (const std::exception& e) {
+        std::cout.rdbuf(stdoutBuffer);
+        std::cerr << e.what() << "\n";
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
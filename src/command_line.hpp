@@ -0,0 +1,276 @@
+#pragma once
+
+#include <cstdint>
+#include <format>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+#include "hello_triangle_application.hpp"
+
+namespace vt::cli {
+
+// Returns the value following the option at 'index' and advances 'index' past it, e.g. '--frames 100'.
+inline auto NextValue(std::span<char*> args, size_t& index) -> std::string {
+    if (index + 1 >= args.size()) {
+        throw std::invalid_argument(std::format("Missing value for option [{}].", args[index]));
+    }
+
+    return args[++index];
+}
+
+inline auto ParseCullMode(std::string_view value) -> VkCullModeFlags {
+    if (value == "none") {
+        return VK_CULL_MODE_NONE;
+    }
+    if (value == "back") {
+        return VK_CULL_MODE_BACK_BIT;
+    }
+    if (value == "front") {
+        return VK_CULL_MODE_FRONT_BIT;
+    }
+
+    throw std::invalid_argument(std::format("Invalid cull mode [{}], expected none, back or front.", value));
+}
+
+inline auto CullModeName(VkCullModeFlags cullMode) -> std::string_view {
+    switch (cullMode) {
+        case VK_CULL_MODE_NONE:       return "none";
+        case VK_CULL_MODE_BACK_BIT:   return "back";
+        case VK_CULL_MODE_FRONT_BIT:  return "front";
+        default:                      return "front and back";
+    }
+}
+
+inline auto ParseCullingMode(std::string_view value) -> triangle::HelloTriangleApplication::CullingMode {
+    using CullingMode = triangle::HelloTriangleApplication::CullingMode;
+
+    if (value == "none") {
+        return CullingMode::NONE;
+    }
+    if (value == "cpu") {
+        return CullingMode::CPU;
+    }
+    if (value == "gpu") {
+        return CullingMode::GPU;
+    }
+
+    throw std::invalid_argument(std::format("Invalid culling mode [{}], expected none, cpu or gpu.", value));
+}
+
+inline auto CullingModeName(triangle::HelloTriangleApplication::CullingMode culling) -> std::string_view {
+    using CullingMode = triangle::HelloTriangleApplication::CullingMode;
+
+    switch (culling) {
+        case CullingMode::CPU: return "cpu";
+        case CullingMode::GPU: return "gpu";
+        default:               return "none";
+    }
+}
+
+inline auto ParsePresentPolicy(std::string_view value) -> triangle::HelloTriangleApplication::PresentPolicy {
+    using PresentPolicy = triangle::HelloTriangleApplication::PresentPolicy;
+
+    if (value == "low-latency") {
+        return PresentPolicy::LOW_LATENCY;
+    }
+    if (value == "throughput") {
+        return PresentPolicy::THROUGHPUT;
+    }
+    if (value == "power-saver") {
+        return PresentPolicy::POWER_SAVER;
+    }
+    if (value == "tear-allowed") {
+        return PresentPolicy::TEAR_ALLOWED;
+    }
+
+    throw std::invalid_argument(std::format("Invalid present policy [{}], expected low-latency, throughput, power-saver or tear-allowed.", value));
+}
+
+inline auto PresentPolicyName(triangle::HelloTriangleApplication::PresentPolicy policy) -> std::string_view {
+    using PresentPolicy = triangle::HelloTriangleApplication::PresentPolicy;
+
+    switch (policy) {
+        case PresentPolicy::THROUGHPUT:   return "throughput";
+        case PresentPolicy::POWER_SAVER:  return "power-saver";
+        case PresentPolicy::TEAR_ALLOWED: return "tear-allowed";
+        default:                          return "low-latency";
+    }
+}
+
+inline auto ParseColorMode(std::string_view value) -> triangle::HelloTriangleApplication::ColorMode {
+    using ColorMode = triangle::HelloTriangleApplication::ColorMode;
+
+    if (value == "mixed") {
+        return ColorMode::MIXED;
+    }
+    if (value == "vertex") {
+        return ColorMode::VERTEX;
+    }
+    if (value == "instance") {
+        return ColorMode::INSTANCE;
+    }
+
+    throw std::invalid_argument(std::format("Invalid color mode [{}], expected mixed, vertex or instance.", value));
+}
+
+inline auto ColorModeName(triangle::HelloTriangleApplication::ColorMode colorMode) -> std::string_view {
+    using ColorMode = triangle::HelloTriangleApplication::ColorMode;
+
+    switch (colorMode) {
+        case ColorMode::VERTEX:   return "vertex";
+        case ColorMode::INSTANCE: return "instance";
+        default:                  return "mixed";
+    }
+}
+
+inline auto ParseDrawOrder(std::string_view value) -> triangle::HelloTriangleApplication::DrawOrder {
+    using DrawOrder = triangle::HelloTriangleApplication::DrawOrder;
+
+    if (value == "unsorted") {
+        return DrawOrder::UNSORTED;
+    }
+    if (value == "front-to-back") {
+        return DrawOrder::FRONT_TO_BACK;
+    }
+    if (value == "back-to-front") {
+        return DrawOrder::BACK_TO_FRONT;
+    }
+
+    throw std::invalid_argument(std::format("Invalid draw order [{}], expected unsorted, front-to-back or back-to-front.", value));
+}
+
+inline auto DrawOrderName(triangle::HelloTriangleApplication::DrawOrder drawOrder) -> std::string_view {
+    using DrawOrder = triangle::HelloTriangleApplication::DrawOrder;
+
+    switch (drawOrder) {
+        case DrawOrder::UNSORTED:      return "unsorted";
+        case DrawOrder::BACK_TO_FRONT: return "back-to-front";
+        default:                       return "front-to-back";
+    }
+}
+
+inline auto ParseValidationSeverity(std::string_view value) -> VkDebugUtilsMessageSeverityFlagBitsEXT {
+    if (value == "verbose") {
+        return VK_DEBUG_UTILS_MESSAGE_SEVERITY_VERBOSE_BIT_EXT;
+    }
+    if (value == "info") {
+        return VK_DEBUG_UTILS_MESSAGE_SEVERITY_INFO_BIT_EXT;
+    }
+    if (value == "warning") {
+        return VK_DEBUG_UTILS_MESSAGE_SEVERITY_WARNING_BIT_EXT;
+    }
+    if (value == "error") {
+        return VK_DEBUG_UTILS_MESSAGE_SEVERITY_ERROR_BIT_EXT;
+    }
+
+    throw std::invalid_argument(std::format("Invalid validation severity [{}], expected verbose, info, warning or error.", value));
+}
+
+inline auto ParseCaptureFormat(std::string_view value) -> capture::Format {
+    if (value == "raw") {
+        return capture::Format::RAW;
+    }
+    if (value == "ppm") {
+        return capture::Format::PPM;
+    }
+    if (value == "png") {
+        return capture::Format::PNG;
+    }
+
+    throw std::invalid_argument(std::format("Invalid capture format [{}], expected raw, ppm or png.", value));
+}
+
+inline auto CaptureFormatName(capture::Format format) -> std::string_view {
+    switch (format) {
+        case capture::Format::RAW: return "raw";
+        case capture::Format::PPM: return "ppm";
+        default:                   return "png";
+    }
+}
+
+// Parses the application option at 'index' into 'settings'.
+// Returns false if the option is not an application option, so that callers can handle their own options.
+inline auto ParseSettingsOption(std::span<char*> args, size_t& index, triangle::HelloTriangleApplication::Settings& settings) -> bool {
+    const std::string_view arg = args[index];
+
+    if (arg == "--frames-in-flight") {
+        settings.framesInFlight = static_cast<uint32_t>(std::stoul(NextValue(args, index)));
+    } else if (arg == "--headless") {
+        settings.headless = true;
+    } else if (arg == "--static-scene") {
+        settings.staticScene = true;
+    } else if (arg == "--present-policy") {
+        settings.presentPolicy = ParsePresentPolicy(NextValue(args, index));
+    } else if (arg == "--no-dynamic-rendering") {
+        settings.dynamicRendering = false;
+    } else if (arg == "--draws") {
+        settings.drawCount = static_cast<uint32_t>(std::stoul(NextValue(args, index)));
+    } else if (arg == "--instances") {
+        settings.instanceCount = static_cast<uint32_t>(std::stoul(NextValue(args, index)));
+    } else if (arg == "--instance-scale") {
+        settings.instanceScale = std::stof(NextValue(args, index));
+    } else if (arg == "--color-mode") {
+        settings.colorMode = ParseColorMode(NextValue(args, index));
+    } else if (arg == "--color-mode-cycle") {
+        settings.colorModeCycle = static_cast<uint32_t>(std::stoul(NextValue(args, index)));
+    } else if (arg == "--blend") {
+        settings.blend = true;
+    } else if (arg == "--no-depth") {
+        settings.depthBuffer = false;
+    } else if (arg == "--draw-order") {
+        settings.drawOrder = ParseDrawOrder(NextValue(args, index));
+    } else if (arg == "--overdraw-stats") {
+        settings.overdrawStats = true;
+    } else if (arg == "--animate") {
+        settings.animateInstances = true;
+    } else if (arg == "--cull-mode") {
+        settings.cullMode = ParseCullMode(NextValue(args, index));
+    } else if (arg == "--culling") {
+        settings.culling = ParseCullingMode(NextValue(args, index));
+    } else if (arg == "--view-zoom") {
+        settings.viewZoom = std::stof(NextValue(args, index));
+        if (settings.viewZoom < 1.0F) {
+            throw std::invalid_argument(std::format("View zoom must be at least 1, got {}.", settings.viewZoom));
+        }
+    } else if (arg == "--record-threads") {
+        settings.recordThreads = static_cast<uint32_t>(std::stoul(NextValue(args, index)));
+    } else if (arg == "--init-threads") {
+        settings.initThreads = static_cast<uint32_t>(std::stoul(NextValue(args, index)));
+    } else if (arg == "--frames") {
+        settings.maxFrames = std::stoull(NextValue(args, index));
+    } else if (arg == "--gpu-stats") {
+        settings.gpuStats = true;
+    } else if (arg == "--no-transfer-queue") {
+        settings.transferQueue = false;
+    } else if (arg == "--upload-stream") {
+        settings.uploadStreamKiB = static_cast<uint32_t>(std::stoul(NextValue(args, index)));
+    } else if (arg == "--pipeline-cache") {
+        settings.pipelineCachePath = NextValue(args, index);
+    } else if (arg == "--no-pipeline-cache") {
+        settings.pipelineCachePath.clear();
+    } else if (arg == "--trace") {
+        settings.tracePath = NextValue(args, index);
+    } else if (arg == "--validation-severity") {
+        settings.validationSeverity = ParseValidationSeverity(NextValue(args, index));
+    } else if (arg == "--validation-repeats") {
+        settings.validationRepeatLimit = static_cast<uint32_t>(std::stoul(NextValue(args, index)));
+    } else if (arg == "--validation-rate") {
+        settings.validationRateLimit = static_cast<uint32_t>(std::stoul(NextValue(args, index)));
+    } else if (arg == "--shader-dir") {
+        settings.shaderDirectory = NextValue(args, index);
+    } else if (arg == "--capture") {
+        settings.capturePath = NextValue(args, index);
+    } else if (arg == "--capture-format") {
+        settings.captureFormat = ParseCaptureFormat(NextValue(args, index));
+    } else if (arg == "--capture-buffers") {
+        settings.captureBuffers = static_cast<uint32_t>(std::stoul(NextValue(args, index)));
+    } else {
+        return false;
+    }
+
+    return true;
+}
+
+}  // namespace vt::cli
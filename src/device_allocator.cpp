@@ -0,0 +1,260 @@
+#include "device_allocator.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <format>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+
+namespace vt::memory {
+
+namespace {
+
+auto AlignUp(VkDeviceSize value, VkDeviceSize alignment) -> VkDeviceSize {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+}  // namespace
+
+DeviceAllocator::DeviceAllocator(VkDevice device, VkPhysicalDevice physicalDevice, VkDeviceSize blockSize) : m_device(device), m_blockSize(blockSize) {
+    VkPhysicalDeviceProperties properties = {};
+    vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+    vkGetPhysicalDeviceMemoryProperties(physicalDevice, &m_memoryProperties);
+
+    m_maxAllocationCount = properties.limits.maxMemoryAllocationCount;
+}
+
+DeviceAllocator::~DeviceAllocator() noexcept {
+    for (const auto& block : m_blocks) {
+        vkFreeMemory(m_device, block->memory, nullptr);
+    }
+}
+
+auto DeviceAllocator::Allocate(const VkMemoryRequirements& requirements, VkMemoryPropertyFlags properties, ResourceKind kind) -> Allocation {
+    const uint32_t         memoryTypeIndex = FindMemoryType(requirements.memoryTypeBits, properties);
+    const VkDeviceSize     blockSize       = BlockSize(memoryTypeIndex);
+    const std::scoped_lock lock(m_mutex);
+
+    Block*                      block  = nullptr;
+    std::optional<VkDeviceSize> offset = std::nullopt;
+
+    // Anything larger than half a block would leave most of a shared block unusable, so it gets a block of its own.
+    if (requirements.size > blockSize / 2) {
+        block  = &CreateBlock(requirements.size, memoryTypeIndex, kind, true);
+        offset = TryAllocate(*block, requirements.size, requirements.alignment);
+    } else {
+        for (const auto& candidate : m_blocks) {
+            if (candidate->dedicated || candidate->memoryTypeIndex != memoryTypeIndex || candidate->kind != kind) {
+                continue;
+            }
+
+            offset = TryAllocate(*candidate, requirements.size, requirements.alignment);
+            if (offset.has_value()) {
+                block = candidate.get();
+                break;
+            }
+        }
+
+        if (nullptr == block) {
+            block  = &CreateBlock(blockSize, memoryTypeIndex, kind, false);
+            offset = TryAllocate(*block, requirements.size, requirements.alignment);
+        }
+    }
+
+    if (!offset.has_value()) {
+        throw std::runtime_error(std::format("DeviceAllocator::Allocate: Failed to allocate {} bytes.", requirements.size));
+    }
+
+    block->allocationCount++;
+    return { .memory = block->memory,
+             .offset = offset.value(),
+             .size   = requirements.size,
+             .mapped = nullptr != block->mapped ? block->mapped + offset.value() : nullptr,
+             .block  = block };
+}
+
+void DeviceAllocator::Free(const Allocation& allocation) {
+    if (nullptr == allocation.block) {
+        return;
+    }
+
+    const std::scoped_lock lock(m_mutex);
+    Block&                 block = *allocation.block;
+
+    if (block.dedicated) {
+        vkFreeMemory(m_device, block.memory, nullptr);
+        std::erase_if(m_blocks, [&](const auto& candidate) { return candidate.get() == &block; });
+        return;
+    }
+
+    // Merge the range with its free neighbours, so that the free list never holds two adjacent ranges.
+    VkDeviceSize offset = allocation.offset;
+    VkDeviceSize size   = allocation.size;
+
+    auto next = block.freeRanges.lower_bound(offset);
+    if (next != block.freeRanges.end() && offset + size == next->first) {
+        size += next->second;
+        next  = block.freeRanges.erase(next);
+    }
+
+    if (next != block.freeRanges.begin()) {
+        auto previous = std::prev(next);
+        if (previous->first + previous->second == offset) {
+            offset  = previous->first;
+            size   += previous->second;
+            block.freeRanges.erase(previous);
+        }
+    }
+
+    block.freeRanges.emplace(offset, size);
+    block.allocationCount--;
+}
+
+auto DeviceAllocator::CreateBuffer(VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties) -> Buffer {
+    const VkBufferCreateInfo bufferInfo = { .sType                 = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
+                                            .pNext                 = nullptr,
+                                            .flags                 = {},
+                                            .size                  = size,
+                                            .usage                 = usage,
+                                            .sharingMode           = VK_SHARING_MODE_EXCLUSIVE,
+                                            .queueFamilyIndexCount = 0,
+                                            .pQueueFamilyIndices   = nullptr };
+
+    Buffer buffer = {};
+    if (const auto& result = vkCreateBuffer(m_device, &bufferInfo, nullptr, &buffer.buffer) != VK_SUCCESS) {
+        throw std::runtime_error(std::format("DeviceAllocator::CreateBuffer: Failed to create buffer, error code: {}.", result));
+    }
+
+    VkMemoryRequirements requirements = {};
+    vkGetBufferMemoryRequirements(m_device, buffer.buffer, &requirements);
+
+    buffer.allocation = Allocate(requirements, properties, ResourceKind::LINEAR);
+    vkBindBufferMemory(m_device, buffer.buffer, buffer.allocation.memory, buffer.allocation.offset);
+
+    return buffer;
+}
+
+void DeviceAllocator::DestroyBuffer(const Buffer& buffer) {
+    vkDestroyBuffer(m_device, buffer.buffer, nullptr);
+    Free(buffer.allocation);
+}
+
+auto DeviceAllocator::CreateImage(const VkImageCreateInfo& createInfo, VkMemoryPropertyFlags properties) -> Image {
+    Image image = {};
+    if (const auto& result = vkCreateImage(m_device, &createInfo, nullptr, &image.image) != VK_SUCCESS) {
+        throw std::runtime_error(std::format("DeviceAllocator::CreateImage: Failed to create image, error code: {}.", result));
+    }
+
+    VkMemoryRequirements requirements = {};
+    vkGetImageMemoryRequirements(m_device, image.image, &requirements);
+
+    const ResourceKind kind = VK_IMAGE_TILING_LINEAR == createInfo.tiling ? ResourceKind::LINEAR : ResourceKind::OPTIMAL;
+    image.allocation        = Allocate(requirements, properties, kind);
+    vkBindImageMemory(m_device, image.image, image.allocation.memory, image.allocation.offset);
+
+    return image;
+}
+
+void DeviceAllocator::DestroyImage(const Image& image) {
+    vkDestroyImage(m_device, image.image, nullptr);
+    Free(image.allocation);
+}
+
+auto DeviceAllocator::GetStats() const -> Stats {
+    const std::scoped_lock lock(m_mutex);
+
+    Stats stats = {};
+    for (const auto& block : m_blocks) {
+        VkDeviceSize freeBytes = 0;
+        for (const auto& [offset, size] : block->freeRanges) {
+            freeBytes              += size;
+            stats.largestFreeRange  = std::max(stats.largestFreeRange, size);
+        }
+
+        stats.deviceAllocationCount++;
+        stats.allocationCount += block->allocationCount;
+        stats.blockBytes      += block->size;
+        stats.usedBytes       += block->size - freeBytes;
+    }
+
+    return stats;
+}
+
+auto DeviceAllocator::FindMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties) const -> uint32_t {
+    for (uint32_t i = 0; i < m_memoryProperties.memoryTypeCount; i++) {
+        if (0 != (typeFilter & (1U << i)) && (m_memoryProperties.memoryTypes[i].propertyFlags & properties) == properties) {
+            return i;
+        }
+    }
+
+    throw std::runtime_error("DeviceAllocator::FindMemoryType: Failed to find a suitable memory type.");
+}
+
+auto DeviceAllocator::BlockSize(uint32_t memoryTypeIndex) const -> VkDeviceSize {
+    // A block never takes more than an eighth of its heap, small heaps (e.g. the 256 MiB BAR) would otherwise run out after a few blocks.
+    const VkDeviceSize heapSize = m_memoryProperties.memoryHeaps[m_memoryProperties.memoryTypes[memoryTypeIndex].heapIndex].size;
+    return std::min(m_blockSize, heapSize / 8);
+}
+
+auto DeviceAllocator::CreateBlock(VkDeviceSize size, uint32_t memoryTypeIndex, ResourceKind kind, bool dedicated) -> Block& {
+    if (m_blocks.size() >= m_maxAllocationCount) {
+        throw std::runtime_error(std::format("DeviceAllocator::CreateBlock: maxMemoryAllocationCount ({}) reached.", m_maxAllocationCount));
+    }
+
+    auto block             = std::make_unique<Block>();
+    block->size            = size;
+    block->memoryTypeIndex = memoryTypeIndex;
+    block->kind            = kind;
+    block->dedicated       = dedicated;
+    block->freeRanges.emplace(0, size);
+
+    const VkMemoryAllocateInfo allocInfo = { .sType           = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
+                                             .pNext           = nullptr,
+                                             .allocationSize  = size,
+                                             .memoryTypeIndex = memoryTypeIndex };
+
+    if (const auto& result = vkAllocateMemory(m_device, &allocInfo, nullptr, &block->memory) != VK_SUCCESS) {
+        throw std::runtime_error(std::format("DeviceAllocator::CreateBlock: Failed to allocate {} bytes, error code: {}.", size, result));
+    }
+
+    if (0 != (m_memoryProperties.memoryTypes[memoryTypeIndex].propertyFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT)) {
+        void* mapped = nullptr;
+        if (const auto& result = vkMapMemory(m_device, block->memory, 0, VK_WHOLE_SIZE, 0, &mapped) != VK_SUCCESS) {
+            vkFreeMemory(m_device, block->memory, nullptr);
+            throw std::runtime_error(std::format("DeviceAllocator::CreateBlock: Failed to map memory, error code: {}.", result));
+        }
+        block->mapped = static_cast<uint8_t*>(mapped);
+    }
+
+    m_blocks.push_back(std::move(block));
+    return *m_blocks.back();
+}
+
+auto DeviceAllocator::TryAllocate(Block& block, VkDeviceSize size, VkDeviceSize alignment) -> std::optional<VkDeviceSize> {
+    // First fit. The padding in front of an aligned offset stays in the free list.
+    for (auto range = block.freeRanges.begin(); range != block.freeRanges.end(); ++range) {
+        const auto [rangeOffset, rangeSize] = *range;
+        const VkDeviceSize offset           = AlignUp(rangeOffset, alignment);
+
+        if (offset + size > rangeOffset + rangeSize) {
+            continue;
+        }
+
+        block.freeRanges.erase(range);
+        if (offset > rangeOffset) {
+            block.freeRanges.emplace(rangeOffset, offset - rangeOffset);
+        }
+        if (offset + size < rangeOffset + rangeSize) {
+            block.freeRanges.emplace(offset + size, rangeOffset + rangeSize - offset - size);
+        }
+
+        return offset;
+    }
+
+    return std::nullopt;
+}
+
+}  // namespace vt::memory
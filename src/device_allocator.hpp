@@ -0,0 +1,117 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+namespace vt::memory {
+
+// Sub-allocates buffers and images from a few large vkAllocateMemory blocks, instead of one allocation per resource,
+// which keeps the application far below maxMemoryAllocationCount. Every memory type gets its own blocks, and linear resources
+// (buffers) and optimal resources (images) never share a block, so bufferImageGranularity can't be violated.
+// Host visible blocks are mapped once for their whole lifetime. All functions are thread safe.
+class DeviceAllocator {
+  private:
+    struct Block;
+
+  public:
+    enum class ResourceKind : uint8_t { LINEAR, OPTIMAL };
+
+    struct Allocation {
+        // NOLINTBEGIN(misc-non-private-member-variables-in-classes)
+        VkDeviceMemory memory = VK_NULL_HANDLE;
+        VkDeviceSize   offset = 0;
+        VkDeviceSize   size   = 0;
+        void*          mapped = nullptr;  // Points at 'offset' when the memory is host visible, otherwise nullptr.
+        Block*         block  = nullptr;
+        // NOLINTEND(misc-non-private-member-variables-in-classes)
+    };
+
+    struct Buffer {
+        // NOLINTBEGIN(misc-non-private-member-variables-in-classes)
+        VkBuffer   buffer = VK_NULL_HANDLE;
+        Allocation allocation;
+        // NOLINTEND(misc-non-private-member-variables-in-classes)
+    };
+
+    struct Image {
+        // NOLINTBEGIN(misc-non-private-member-variables-in-classes)
+        VkImage    image = VK_NULL_HANDLE;
+        Allocation allocation;
+        // NOLINTEND(misc-non-private-member-variables-in-classes)
+    };
+
+    struct Stats {
+        // NOLINTBEGIN(misc-non-private-member-variables-in-classes)
+        uint32_t     deviceAllocationCount = 0;  // Live vkAllocateMemory allocations, i.e. blocks.
+        uint32_t     allocationCount       = 0;  // Live sub-allocations handed out.
+        VkDeviceSize blockBytes            = 0;
+        VkDeviceSize usedBytes             = 0;
+        VkDeviceSize largestFreeRange      = 0;
+        // NOLINTEND(misc-non-private-member-variables-in-classes)
+
+        // 0 when all free space is one contiguous range, approaching 1 as it splits into small pieces.
+        [[nodiscard]] auto Fragmentation() const -> double {
+            const VkDeviceSize freeBytes = blockBytes - usedBytes;
+            return 0 == freeBytes ? 0.0 : 1.0 - (static_cast<double>(largestFreeRange) / static_cast<double>(freeBytes));
+        }
+    };
+
+    static constexpr VkDeviceSize kDefaultBlockSize = VkDeviceSize { 64 } * 1024 * 1024;
+
+    DeviceAllocator(VkDevice device, VkPhysicalDevice physicalDevice, VkDeviceSize blockSize = kDefaultBlockSize);
+    ~DeviceAllocator() noexcept;
+
+    // Copy constructor and assignment operator.
+    DeviceAllocator(const DeviceAllocator& other)                    = delete;
+    auto operator=(const DeviceAllocator& other) -> DeviceAllocator& = delete;
+
+    // Move constructor and move assignment operator.
+    DeviceAllocator(DeviceAllocator&& other) noexcept                    = delete;
+    auto operator=(DeviceAllocator&& other) noexcept -> DeviceAllocator& = delete;
+
+    auto Allocate(const VkMemoryRequirements& requirements, VkMemoryPropertyFlags properties, ResourceKind kind) -> Allocation;
+    void Free(const Allocation& allocation);
+
+    auto CreateBuffer(VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties) -> Buffer;
+    void DestroyBuffer(const Buffer& buffer);
+
+    auto CreateImage(const VkImageCreateInfo& createInfo, VkMemoryPropertyFlags properties) -> Image;
+    void DestroyImage(const Image& image);
+
+    [[nodiscard]] auto GetStats() const -> Stats;
+
+  private:
+    struct Block {
+        // NOLINTBEGIN(misc-non-private-member-variables-in-classes)
+        VkDeviceMemory                       memory          = VK_NULL_HANDLE;
+        VkDeviceSize                         size            = 0;
+        uint32_t                             memoryTypeIndex = 0;
+        ResourceKind                         kind            = ResourceKind::LINEAR;
+        bool                                 dedicated       = false;  // Holds a single resource larger than the block size.
+        uint8_t*                             mapped          = nullptr;
+        std::map<VkDeviceSize, VkDeviceSize> freeRanges;               // Offset to size, adjacent ranges are always merged.
+        uint32_t                             allocationCount = 0;
+        // NOLINTEND(misc-non-private-member-variables-in-classes)
+    };
+
+    auto FindMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties) const -> uint32_t;
+    auto BlockSize(uint32_t memoryTypeIndex) const -> VkDeviceSize;
+    auto CreateBlock(VkDeviceSize size, uint32_t memoryTypeIndex, ResourceKind kind, bool dedicated) -> Block&;
+    static auto TryAllocate(Block& block, VkDeviceSize size, VkDeviceSize alignment) -> std::optional<VkDeviceSize>;
+
+    VkDevice                         m_device             = VK_NULL_HANDLE;
+    VkDeviceSize                     m_blockSize          = kDefaultBlockSize;
+    VkPhysicalDeviceMemoryProperties m_memoryProperties   = {};
+    uint32_t                         m_maxAllocationCount = 0;
+
+    mutable std::mutex                  m_mutex;
+    std::vector<std::unique_ptr<Block>> m_blocks;
+};
+
+}  // namespace vt::memory
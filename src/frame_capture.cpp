@@ -0,0 +1,506 @@
+#include "frame_capture.hpp"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <exception>
+#include <format>
+#include <iostream>
+#include <mutex>
+#include <span>
+#include <stdexcept>
+#include <stop_token>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "trace.hpp"
+
+namespace vt::capture {
+
+namespace {
+
+constexpr uint32_t kBytesPerPixel    = 4;
+constexpr uint32_t kMaxStoredBlock   = 65535;  // Largest stored deflate block.
+constexpr uint32_t kAdlerModulus     = 65521;
+constexpr size_t   kPngChunkOverhead = 12;  // Length, type and CRC.
+
+constexpr auto kCrcTable = []() {
+    std::array<uint32_t, 256> table = {};
+    for (uint32_t n = 0; n < table.size(); n++) {
+        uint32_t crc = n;
+        for (uint32_t bit = 0; bit < 8; bit++) {
+            crc = 0 != (crc & 1U) ? 0xEDB88320U ^ (crc >> 1U) : crc >> 1U;
+        }
+        table[n] = crc;
+    }
+    return table;
+}();
+
+auto Crc32(std::span<const std::byte> data) -> uint32_t {
+    uint32_t crc = 0xFFFFFFFFU;
+    for (const std::byte value : data) {
+        crc = kCrcTable[(crc ^ static_cast<uint32_t>(value)) & 0xFFU] ^ (crc >> 8U);
+    }
+    return ~crc;
+}
+
+// Writes into a buffer sized up front, so the encoders never reallocate once the buffer has grown to the frame size.
+class ByteWriter {
+  public:
+    ByteWriter(std::vector<std::byte>& out, size_t size) : m_out(out) { m_out.resize(size); }
+
+    void Byte(uint32_t value) { m_out[m_position++] = static_cast<std::byte>(value & 0xFFU); }
+
+    void BigEndian32(uint32_t value) {
+        Byte(value >> 24U);
+        Byte(value >> 16U);
+        Byte(value >> 8U);
+        Byte(value);
+    }
+
+    void LittleEndian16(uint32_t value) {
+        Byte(value);
+        Byte(value >> 8U);
+    }
+
+    void Text(std::string_view text) {
+        for (const char c : text) {
+            Byte(static_cast<uint8_t>(c));
+        }
+    }
+
+    [[nodiscard]] auto Position() const -> size_t { return m_position; }
+    [[nodiscard]] auto Written(size_t from) const -> std::span<const std::byte> { return { m_out.data() + from, m_position - from }; }
+
+  private:
+    std::vector<std::byte>& m_out;
+    size_t                  m_position = 0;
+};
+
+// A zlib stream of stored deflate blocks, the cheapest valid encoding of the PNG image data.
+class StoredDeflate {
+  public:
+    StoredDeflate(ByteWriter& writer, size_t size) : m_writer(writer), m_left(size) {
+        m_writer.Byte(0x78);  // 32K window, deflate.
+        m_writer.Byte(0x01);  // No preset dictionary, check bits for the header.
+    }
+
+    static auto EncodedSize(size_t size) -> size_t {
+        const size_t blocks = std::max<size_t>((size + kMaxStoredBlock - 1) / kMaxStoredBlock, 1);
+        return 2 + (blocks * 5) + size + 4;
+    }
+
+    void Byte(uint32_t value) {
+        if (0 == m_blockLeft) {
+            BeginBlock();
+        }
+
+        m_writer.Byte(value);
+        m_blockLeft--;
+        m_left--;
+
+        // Both sums stay below twice the modulus, so a subtraction replaces the division.
+        m_adlerA += value & 0xFFU;
+        m_adlerA -= m_adlerA >= kAdlerModulus ? kAdlerModulus : 0;
+        m_adlerB += m_adlerA;
+        m_adlerB -= m_adlerB >= kAdlerModulus ? kAdlerModulus : 0;
+    }
+
+    void Finish() {
+        if (0 == m_blocks) {
+            BeginBlock();
+        }
+        m_writer.BigEndian32((m_adlerB << 16U) | m_adlerA);
+    }
+
+  private:
+    void BeginBlock() {
+        const auto size = static_cast<uint32_t>(std::min<size_t>(m_left, kMaxStoredBlock));
+        m_writer.Byte(size == m_left ? 1 : 0);  // BFINAL, BTYPE 00.
+        m_writer.LittleEndian16(size);
+        m_writer.LittleEndian16(~size);
+        m_blockLeft = size;
+        m_blocks++;
+    }
+
+    ByteWriter& m_writer;
+    size_t      m_left      = 0;
+    uint32_t    m_blockLeft = 0;
+    uint32_t    m_blocks    = 0;
+    uint32_t    m_adlerA    = 1;
+    uint32_t    m_adlerB    = 0;
+};
+
+auto IsBgra(VkFormat format) -> bool {
+    switch (format) {
+        case VK_FORMAT_B8G8R8A8_UNORM:
+        case VK_FORMAT_B8G8R8A8_SRGB:  return true;
+        case VK_FORMAT_R8G8B8A8_UNORM:
+        case VK_FORMAT_R8G8B8A8_SRGB:  return false;
+        default:                       throw std::runtime_error(std::format("FrameCapture::FrameCapture: Unsupported image format: {}.", static_cast<int32_t>(format)));
+    }
+}
+
+}  // namespace
+
+void EncodeFrame(Format format, std::span<const std::byte> pixels, uint32_t width, uint32_t height, bool bgra, std::vector<std::byte>& out) {
+    const size_t rowSize = size_t { width } * kBytesPerPixel;
+    if (pixels.size() < rowSize * height) {
+        throw std::invalid_argument(std::format("EncodeFrame: {} bytes is too small for a {}x{} frame.", pixels.size(), width, height));
+    }
+
+    const size_t red  = bgra ? 2 : 0;
+    const size_t blue = bgra ? 0 : 2;
+
+    switch (format) {
+        case Format::RAW: {
+            ByteWriter writer(out, rowSize * height);
+            for (size_t i = 0; i < rowSize * height; i += kBytesPerPixel) {
+                writer.Byte(static_cast<uint32_t>(pixels[i + red]));
+                writer.Byte(static_cast<uint32_t>(pixels[i + 1]));
+                writer.Byte(static_cast<uint32_t>(pixels[i + blue]));
+                writer.Byte(static_cast<uint32_t>(pixels[i + 3]));
+            }
+            return;
+        }
+
+        case Format::PPM: {
+            std::array<char, 64> header       = {};
+            const auto           headerLength = std::format_to_n(header.data(), header.size(), "P6\n{} {}\n255\n", width, height).size;
+
+            ByteWriter writer(out, static_cast<size_t>(headerLength) + (size_t { width } * height * 3));
+            writer.Text({ header.data(), static_cast<size_t>(headerLength) });
+            for (size_t i = 0; i < rowSize * height; i += kBytesPerPixel) {
+                writer.Byte(static_cast<uint32_t>(pixels[i + red]));
+                writer.Byte(static_cast<uint32_t>(pixels[i + 1]));
+                writer.Byte(static_cast<uint32_t>(pixels[i + blue]));
+            }
+            return;
+        }
+
+        case Format::PNG: {
+            // Every scanline starts with its filter type, 0 is none.
+            const size_t imageDataSize = (rowSize + 1) * height;
+            const size_t zlibSize      = StoredDeflate::EncodedSize(imageDataSize);
+
+            ByteWriter writer(out, 8 + (kPngChunkOverhead + 13) + (kPngChunkOverhead + zlibSize) + kPngChunkOverhead);
+            writer.Text("\x89PNG\r\n\x1A\n");
+
+            // The CRC covers the chunk type and data, not the length.
+            const auto chunk = [&writer](std::string_view type, uint32_t length, const auto& writeData) {
+                writer.BigEndian32(length);
+                const size_t start = writer.Position();
+                writer.Text(type);
+                writeData();
+                writer.BigEndian32(Crc32(writer.Written(start)));
+            };
+
+            chunk("IHDR", 13, [&]() {
+                writer.BigEndian32(width);
+                writer.BigEndian32(height);
+                writer.Byte(8);  // Bit depth.
+                writer.Byte(6);  // Color type, RGBA.
+                writer.Byte(0);  // Compression method, deflate.
+                writer.Byte(0);  // Filter method.
+                writer.Byte(0);  // No interlacing.
+            });
+
+            chunk("IDAT", static_cast<uint32_t>(zlibSize), [&]() {
+                StoredDeflate deflate(writer, imageDataSize);
+                for (size_t row = 0; row < height; row++) {
+                    deflate.Byte(0);
+                    for (size_t i = row * rowSize; i < (row + 1) * rowSize; i += kBytesPerPixel) {
+                        deflate.Byte(static_cast<uint32_t>(pixels[i + red]));
+                        deflate.Byte(static_cast<uint32_t>(pixels[i + 1]));
+                        deflate.Byte(static_cast<uint32_t>(pixels[i + blue]));
+                        deflate.Byte(static_cast<uint32_t>(pixels[i + 3]));
+                    }
+                }
+                deflate.Finish();
+            });
+
+            chunk("IEND", 0, []() {});
+            return;
+        }
+    }
+}
+
+FrameCapture::FrameCapture(VkDevice device, memory::DeviceAllocator& allocator, VkSemaphore timeline, const Config& config)
+    : m_device(device),
+      m_allocator(allocator),
+      m_timeline(timeline),
+      m_config(config),
+      m_frameSize(VkDeviceSize { config.extent.width } * config.extent.height * kBytesPerPixel),
+      m_bgra(IsBgra(config.imageFormat)),
+      m_perFrame(std::string::npos != config.path.find('{')),
+      m_slots(std::max(config.bufferCount, 1U)) {
+    if (m_perFrame) {
+        const uint64_t frameNumber = 0;
+        static_cast<void>(std::vformat(m_config.path, std::make_format_args(frameNumber)));  // Throws std::format_error for an invalid pattern.
+    } else if (m_config.path == "-") {
+        m_stream = stdout;
+    } else {
+        m_stream = std::fopen(m_config.path.c_str(), "wb");  // NOLINT(cppcoreguidelines-owning-memory)
+        if (nullptr == m_stream) {
+            throw std::runtime_error(std::format("FrameCapture::FrameCapture: Failed to open file: [{}].", m_config.path));
+        }
+    }
+
+    CreateBuffers();
+    m_recorded.reserve(m_slots.size());
+
+    m_thread = std::jthread([this](const std::stop_token& stopToken) { WriterLoop(stopToken); });
+}
+
+FrameCapture::~FrameCapture() noexcept {
+    m_thread.request_stop();
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+
+    for (auto& slot : m_slots) {
+        m_allocator.DestroyBuffer(slot.buffer);
+    }
+
+    if (nullptr != m_stream && stdout != m_stream) {
+        std::fclose(m_stream);  // NOLINT(cppcoreguidelines-owning-memory)
+    } else if (nullptr != m_stream) {
+        std::fflush(m_stream);
+    }
+}
+
+void FrameCapture::Drain() const {
+    for (const auto& slot : m_slots) {
+        slot.busy.wait(true, std::memory_order_acquire);
+    }
+}
+
+void FrameCapture::Resize(VkExtent2D extent, VkFormat imageFormat) {
+    // Once every buffer is free the writer is idle, the next Commit publishes the new configuration to it through the queue mutex.
+    Drain();
+
+    m_config.extent      = extent;
+    m_config.imageFormat = imageFormat;
+    m_bgra               = IsBgra(imageFormat);
+    m_frameSize          = VkDeviceSize { extent.width } * extent.height * kBytesPerPixel;
+
+    for (auto& slot : m_slots) {
+        m_allocator.DestroyBuffer(slot.buffer);
+    }
+    CreateBuffers();
+}
+
+auto FrameCapture::Record(VkCommandBuffer commandBuffer, VkImage image, VkImageLayout layout, uint64_t frameNumber, uint64_t timelineValue) -> bool {
+    // Buffers are used round robin and the writer releases them in the same order, so a busy next buffer means the writer is behind.
+    const uint32_t slotIndex = m_nextSlot;
+    Slot&          slot      = m_slots[slotIndex];
+    if (slot.busy.load(std::memory_order_acquire)) {
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    slot.busy.store(true, std::memory_order_relaxed);
+    m_nextSlot = (m_nextSlot + 1) % static_cast<uint32_t>(m_slots.size());
+
+    const VkImageSubresourceRange range = { .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT, .baseMipLevel = 0, .levelCount = 1, .baseArrayLayer = 0, .layerCount = 1 };
+
+    // The image was last written as a color attachment, possibly transitioned since, hence all commands as the source scope.
+    std::array<VkImageMemoryBarrier2, 2> imageBarriers = { { { .sType               = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2,
+                                                               .pNext               = nullptr,
+                                                               .srcStageMask        = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT,
+                                                               .srcAccessMask       = VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT,
+                                                               .dstStageMask        = VK_PIPELINE_STAGE_2_COPY_BIT,
+                                                               .dstAccessMask       = VK_ACCESS_2_TRANSFER_READ_BIT,
+                                                               .oldLayout           = layout,
+                                                               .newLayout           = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                                                               .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                                                               .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                                                               .image               = image,
+                                                               .subresourceRange    = range },
+                                                             { .sType               = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2,
+                                                               .pNext               = nullptr,
+                                                               .srcStageMask        = VK_PIPELINE_STAGE_2_COPY_BIT,
+                                                               .srcAccessMask       = VK_ACCESS_2_NONE,
+                                                               .dstStageMask        = VK_PIPELINE_STAGE_2_NONE,
+                                                               .dstAccessMask       = VK_ACCESS_2_NONE,
+                                                               .oldLayout           = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                                                               .newLayout           = layout,
+                                                               .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                                                               .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                                                               .image               = image,
+                                                               .subresourceRange    = range } } };
+
+    // The host reads the buffer once the frame timeline has been signaled, which on its own only makes the copy available to the device.
+    const VkBufferMemoryBarrier2 hostBarrier = { .sType               = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2,
+                                                 .pNext               = nullptr,
+                                                 .srcStageMask        = VK_PIPELINE_STAGE_2_COPY_BIT,
+                                                 .srcAccessMask       = VK_ACCESS_2_TRANSFER_WRITE_BIT,
+                                                 .dstStageMask        = VK_PIPELINE_STAGE_2_HOST_BIT,
+                                                 .dstAccessMask       = VK_ACCESS_2_HOST_READ_BIT,
+                                                 .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                                                 .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                                                 .buffer              = slot.buffer.buffer,
+                                                 .offset              = 0,
+                                                 .size                = m_frameSize };
+
+    VkDependencyInfo dependencyInfo = { .sType                    = VK_STRUCTURE_TYPE_DEPENDENCY_INFO,
+                                        .pNext                    = nullptr,
+                                        .dependencyFlags          = {},
+                                        .memoryBarrierCount       = 0,
+                                        .pMemoryBarriers          = nullptr,
+                                        .bufferMemoryBarrierCount = 0,
+                                        .pBufferMemoryBarriers    = nullptr,
+                                        .imageMemoryBarrierCount  = 1,
+                                        .pImageMemoryBarriers     = imageBarriers.data() };
+    vkCmdPipelineBarrier2(commandBuffer, &dependencyInfo);
+
+    const VkBufferImageCopy region = { .bufferOffset      = 0,
+                                       .bufferRowLength   = 0,
+                                       .bufferImageHeight = 0,
+                                       .imageSubresource  = { .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT, .mipLevel = 0, .baseArrayLayer = 0, .layerCount = 1 },
+                                       .imageOffset       = { .x = 0, .y = 0, .z = 0 },
+                                       .imageExtent       = { .width = m_config.extent.width, .height = m_config.extent.height, .depth = 1 } };
+    vkCmdCopyImageToBuffer(commandBuffer, image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, slot.buffer.buffer, 1, &region);
+
+    // Back to the layout the image came in with, e.g. for presentation, unless it already was TRANSFER_SRC_OPTIMAL.
+    const bool restoreLayout                = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL != layout;
+    dependencyInfo.bufferMemoryBarrierCount = 1;
+    dependencyInfo.pBufferMemoryBarriers    = &hostBarrier;
+    dependencyInfo.imageMemoryBarrierCount  = restoreLayout ? 1 : 0;
+    dependencyInfo.pImageMemoryBarriers     = restoreLayout ? &imageBarriers[1] : nullptr;
+    vkCmdPipelineBarrier2(commandBuffer, &dependencyInfo);
+
+    m_recorded.push_back({ .slot = slotIndex, .frameNumber = frameNumber, .timelineValue = timelineValue });
+    m_captured.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+void FrameCapture::Commit() {
+    if (m_recorded.empty()) {
+        return;
+    }
+
+    {
+        const std::scoped_lock lock(m_mutex);
+        m_queue.insert(m_queue.end(), m_recorded.begin(), m_recorded.end());
+    }
+    m_condition.notify_one();
+    m_recorded.clear();
+}
+
+void FrameCapture::Abandon() {
+    if (m_recorded.empty()) {
+        return;
+    }
+
+    // The writer never sees these frames, so their buffers are released here. Rewinding keeps the buffers in the order the writer releases them.
+    m_nextSlot = m_recorded.front().slot;
+    for (const auto& frame : m_recorded) {
+        m_slots[frame.slot].busy.store(false, std::memory_order_release);
+        m_slots[frame.slot].busy.notify_all();
+    }
+
+    m_captured.fetch_sub(m_recorded.size(), std::memory_order_relaxed);
+    m_recorded.clear();
+}
+
+auto FrameCapture::GetStats() const -> Stats {
+    return { .captured     = m_captured.load(std::memory_order_relaxed),
+             .written      = m_written.load(std::memory_order_relaxed),
+             .dropped      = m_dropped.load(std::memory_order_relaxed),
+             .failed       = m_failed.load(std::memory_order_relaxed),
+             .writtenBytes = m_writtenBytes.load(std::memory_order_relaxed),
+             .maxWriteTime = std::chrono::nanoseconds(m_maxWriteTimeNs.load(std::memory_order_relaxed)) };
+}
+
+void FrameCapture::CreateBuffers() {
+    // Host cached memory makes the writer's reads from the mapped buffers far cheaper, plain host visible memory is the fallback.
+    const auto properties = static_cast<VkMemoryPropertyFlags>(VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) |
+                            static_cast<VkMemoryPropertyFlags>(VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+    for (auto& slot : m_slots) {
+        try {
+            slot.buffer = m_allocator.CreateBuffer(m_frameSize, VK_BUFFER_USAGE_TRANSFER_DST_BIT, properties | VK_MEMORY_PROPERTY_HOST_CACHED_BIT);
+        } catch (const std::runtime_error&) {
+            slot.buffer = m_allocator.CreateBuffer(m_frameSize, VK_BUFFER_USAGE_TRANSFER_DST_BIT, properties);
+        }
+    }
+}
+
+void FrameCapture::WriterLoop(const std::stop_token& stopToken) {
+    trace::SetThreadName("frame writer");
+
+    // Committed frames were all submitted, so once stopping the writer drains the queue instead of discarding it.
+    while (true) {
+        PendingFrame frame = {};
+        {
+            std::unique_lock lock(m_mutex);
+            if (!m_condition.wait(lock, stopToken, [this]() { return !m_queue.empty(); })) {
+                return;
+            }
+
+            frame = m_queue.front();
+            m_queue.pop_front();
+        }
+
+        try {
+            Write(frame);
+        } catch (const std::exception& e) {
+            std::cerr << std::format("FrameCapture::WriterLoop: Failed to write frame {}: {}\n", frame.frameNumber, e.what());
+            m_failed.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        m_slots[frame.slot].busy.store(false, std::memory_order_release);
+        m_slots[frame.slot].busy.notify_all();
+    }
+}
+
+void FrameCapture::Write(const PendingFrame& frame) {
+    const VkSemaphoreWaitInfo waitInfo = { .sType          = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO,
+                                           .pNext          = nullptr,
+                                           .flags          = {},
+                                           .semaphoreCount = 1,
+                                           .pSemaphores    = &m_timeline,
+                                           .pValues        = &frame.timelineValue };
+
+    if (const auto& result = vkWaitSemaphores(m_device, &waitInfo, UINT64_MAX) != VK_SUCCESS) {
+        throw std::runtime_error(std::format("Failed to wait for the frame timeline, error code: {}.", result));
+    }
+
+    VT_TRACE_ZONE("WriteFrame");
+    const auto start = std::chrono::steady_clock::now();
+
+    const std::span<const std::byte> pixels = { static_cast<const std::byte*>(m_slots[frame.slot].buffer.allocation.mapped), static_cast<size_t>(m_frameSize) };
+
+    // Raw RGBA frames are written straight from the mapped buffer, everything else is converted first.
+    std::span<const std::byte> data = pixels;
+    if (Format::RAW != m_config.format || m_bgra) {
+        EncodeFrame(m_config.format, pixels, m_config.extent.width, m_config.extent.height, m_bgra, m_encoded);
+        data = m_encoded;
+    }
+
+    if (m_perFrame) {
+        const std::string path = std::vformat(m_config.path, std::make_format_args(frame.frameNumber));
+        std::FILE*        file = std::fopen(path.c_str(), "wb");  // NOLINT(cppcoreguidelines-owning-memory)
+        if (nullptr == file) {
+            throw std::runtime_error(std::format("Failed to open file: [{}].", path));
+        }
+
+        const size_t written = std::fwrite(data.data(), 1, data.size(), file);
+        if (0 != std::fclose(file) || written != data.size()) {  // NOLINT(cppcoreguidelines-owning-memory)
+            throw std::runtime_error(std::format("Failed to write file: [{}].", path));
+        }
+    } else if (std::fwrite(data.data(), 1, data.size(), m_stream) != data.size()) {
+        throw std::runtime_error(std::format("Failed to write to [{}].", m_config.path));
+    }
+
+    const auto writeTime = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+    m_maxWriteTimeNs.store(std::max(m_maxWriteTimeNs.load(std::memory_order_relaxed), static_cast<int64_t>(writeTime)), std::memory_order_relaxed);
+    m_writtenBytes.fetch_add(data.size(), std::memory_order_relaxed);
+    m_written.fetch_add(1, std::memory_order_relaxed);
+}
+
+}  // namespace vt::capture
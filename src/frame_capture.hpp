@@ -0,0 +1,140 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <span>
+#include <stop_token>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "device_allocator.hpp"
+
+namespace vt::capture {
+
+// RAW is tightly packed RGBA, PPM is binary RGB (P6) without alpha, PNG is RGBA.
+enum class Format : uint8_t { RAW, PPM, PNG };
+
+// Encodes a tightly packed frame of 8-bit RGBA pixels, or BGRA with 'bgra', into 'out'. 'out' is resized to the encoded size and meant to be reused,
+// so encoding allocates nothing once it has grown to the frame size. PNG image data is written as stored deflate blocks: compressing would cost more
+// CPU time than the bytes it saves, an external encoder can do better.
+void EncodeFrame(Format format, std::span<const std::byte> pixels, uint32_t width, uint32_t height, bool bgra, std::vector<std::byte>& out);
+
+// Copies rendered frames into a ring of persistently mapped host visible buffers and writes them out on a writer thread.
+// The render thread never waits: when the writer hasn't released the next buffer yet, the frame is dropped and counted instead.
+// The writer waits for each frame on the frame timeline semaphore, so it never reads a buffer the GPU is still copying into.
+//
+// Record, Commit and Abandon must be called from the thread that submits the frames.
+class FrameCapture {
+  public:
+    struct Config {
+        // NOLINTBEGIN(misc-non-private-member-variables-in-classes)
+        Format      format      = Format::PNG;
+        std::string path        = {};  // With a '{}' field one file per frame, formatted with the frame number, otherwise one stream of frames. '-' is stdout.
+        VkExtent2D  extent      = {};
+        VkFormat    imageFormat = VK_FORMAT_B8G8R8A8_SRGB;  // An 8-bit RGBA or BGRA format.
+        uint32_t    bufferCount = 3;                        // Readback buffers, i.e. frames that may wait for the writer before frames are dropped.
+        // NOLINTEND(misc-non-private-member-variables-in-classes)
+    };
+
+    struct Stats {
+        // NOLINTBEGIN(misc-non-private-member-variables-in-classes)
+        uint64_t                 captured     = 0;  // Frames copied into a readback buffer.
+        uint64_t                 written      = 0;
+        uint64_t                 dropped      = 0;  // Frames not captured because every readback buffer was still waiting for the writer.
+        uint64_t                 failed       = 0;  // Frames that couldn't be written.
+        uint64_t                 writtenBytes = 0;
+        std::chrono::nanoseconds maxWriteTime = {};  // Encoding and writing a single frame.
+        // NOLINTEND(misc-non-private-member-variables-in-classes)
+    };
+
+    // 'timeline' is the frame timeline semaphore, whose value passed to Record is signaled once the frame, including the copy, has finished.
+    FrameCapture(VkDevice device, memory::DeviceAllocator& allocator, VkSemaphore timeline, const Config& config);
+
+    // Writes every committed frame, waiting for the GPU where needed, then joins the writer thread.
+    ~FrameCapture() noexcept;
+
+    // Copy constructor and assignment operator.
+    FrameCapture(const FrameCapture& other)                    = delete;
+    auto operator=(const FrameCapture& other) -> FrameCapture& = delete;
+
+    // Move constructor and move assignment operator.
+    FrameCapture(FrameCapture&& other) noexcept                    = delete;
+    auto operator=(FrameCapture&& other) noexcept -> FrameCapture& = delete;
+
+    // Records the copy of 'image', currently in 'layout' and left in it, into the next readback buffer. Returns false and records nothing
+    // when that buffer is still waiting for the writer. 'commandBuffer' must be submitted to a graphics or transfer queue.
+    auto Record(VkCommandBuffer commandBuffer, VkImage image, VkImageLayout layout, uint64_t frameNumber, uint64_t timelineValue) -> bool;
+
+    // Hands the frames recorded since the last call to the writer thread, once their submission has succeeded.
+    void Commit();
+
+    // Releases the buffers of the frames recorded since the last Commit when their submission failed, they are never written.
+    void Abandon();
+
+    // Waits until the writer has written every committed frame.
+    void Drain() const;
+
+    // Drains, then replaces the readback buffers with ones for the new extent and format. In stream mode the frame size changes mid-stream.
+    void Resize(VkExtent2D extent, VkFormat imageFormat);
+
+    [[nodiscard]] auto GetExtent() const -> VkExtent2D { return m_config.extent; }
+    [[nodiscard]] auto GetStats() const -> Stats;
+
+  private:
+    struct Slot {
+        // NOLINTBEGIN(misc-non-private-member-variables-in-classes)
+        memory::DeviceAllocator::Buffer buffer;
+        std::atomic<bool>               busy = false;  // From Record until the writer has written the frame, notified when cleared.
+        // NOLINTEND(misc-non-private-member-variables-in-classes)
+    };
+
+    struct PendingFrame {
+        // NOLINTBEGIN(misc-non-private-member-variables-in-classes)
+        uint32_t slot          = 0;
+        uint64_t frameNumber   = 0;
+        uint64_t timelineValue = 0;
+        // NOLINTEND(misc-non-private-member-variables-in-classes)
+    };
+
+    void CreateBuffers();
+    void WriterLoop(const std::stop_token& stopToken);
+    void Write(const PendingFrame& frame);
+
+    VkDevice                 m_device    = VK_NULL_HANDLE;
+    memory::DeviceAllocator& m_allocator;
+    VkSemaphore              m_timeline  = VK_NULL_HANDLE;
+    Config                   m_config;
+    VkDeviceSize             m_frameSize = 0;
+    bool                     m_bgra      = false;
+    bool                     m_perFrame  = false;    // One file per frame rather than one stream.
+    std::FILE*               m_stream    = nullptr;  // Only used without per frame files.
+
+    std::vector<Slot>         m_slots;
+    uint32_t                  m_nextSlot = 0;  // Only used by the render thread.
+    std::vector<PendingFrame> m_recorded;      // Recorded but not yet committed, only used by the render thread.
+
+    std::vector<std::byte> m_encoded;  // Only used by the writer thread.
+
+    std::atomic<uint64_t> m_captured       = 0;
+    std::atomic<uint64_t> m_written        = 0;
+    std::atomic<uint64_t> m_dropped        = 0;
+    std::atomic<uint64_t> m_failed         = 0;
+    std::atomic<uint64_t> m_writtenBytes   = 0;
+    std::atomic<int64_t>  m_maxWriteTimeNs = 0;
+
+    std::mutex                  m_mutex;
+    std::condition_variable_any m_condition;
+    std::deque<PendingFrame>    m_queue;
+    std::jthread                m_thread;  // Last, so it starts after and stops before everything it uses.
+};
+
+}  // namespace vt::capture
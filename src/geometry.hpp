@@ -0,0 +1,187 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+namespace vt::geometry {
+
+// Matches the vertex inputs of triangle.vert.
+struct Vertex {
+    // NOLINTBEGIN(misc-non-private-member-variables-in-classes)
+    glm::vec2 position;
+    glm::vec3 color;
+    // NOLINTEND(misc-non-private-member-variables-in-classes)
+
+    static auto GetBindingDescription() -> VkVertexInputBindingDescription {
+        return { .binding = 0, .stride = sizeof(Vertex), .inputRate = VK_VERTEX_INPUT_RATE_VERTEX };
+    }
+
+    static auto GetAttributeDescriptions() -> std::array<VkVertexInputAttributeDescription, 2> {
+        // clang-format off
+        return { { { .location = 0, .binding = 0, .format = VK_FORMAT_R32G32_SFLOAT,    .offset = offsetof(Vertex, position) },
+                   { .location = 1, .binding = 0, .format = VK_FORMAT_R32G32B32_SFLOAT, .offset = offsetof(Vertex, color) } } };
+        // clang-format on
+    }
+};
+
+using Index = uint16_t;
+
+inline constexpr VkIndexType kIndexType = VK_INDEX_TYPE_UINT16;
+
+// clang-format off
+inline const std::array<Vertex, 3> kTriangleVertices = { { { .position = {  0.0F, -0.5F }, .color = { 1.0F, 0.0F, 0.0F } },
+                                                           { .position = {  0.5F,  0.5F }, .color = { 0.0F, 1.0F, 0.0F } },
+                                                           { .position = { -0.5F,  0.5F }, .color = { 0.0F, 0.0F, 1.0F } } } };
+// clang-format on
+
+inline constexpr std::array<Index, 3> kTriangleIndices = { 0, 1, 2 };
+
+// Distance from the origin to the furthest vertex of kTriangleVertices, i.e. the bounding circle radius of an unscaled instance.
+inline constexpr float kTriangleBoundingRadius = 0.70711F;
+
+// Per-instance data read by triangle.vert from a storage buffer, laid out to match std430.
+struct InstanceData {
+    // NOLINTBEGIN(misc-non-private-member-variables-in-classes)
+    glm::vec2 offset;
+    float     scale;
+    float     rotation;
+    glm::vec3 color;
+    float     depth;  // Clip space depth in [0, 1), 0 is nearest. The camera only pans and zooms, so it is also the view depth.
+    // NOLINTEND(misc-non-private-member-variables-in-classes)
+};
+
+static_assert(sizeof(InstanceData) == 32, "InstanceData must match the std430 layout in triangle.vert.");
+
+// A single instance reproduces the plain triangle. More instances fill a square grid covering the whole viewport,
+// each scaled to its cell times 'scale', so 'scale' controls how many pixels every triangle covers.
+inline auto MakeInstanceGrid(uint32_t count, float scale) -> std::vector<InstanceData> {
+    if (count <= 1) {
+        return { { .offset = { 0.0F, 0.0F }, .scale = 1.0F, .rotation = 0.0F, .color = { 1.0F, 1.0F, 1.0F }, .depth = 0.5F } };
+    }
+
+    const auto  side = static_cast<uint32_t>(std::ceil(std::sqrt(static_cast<double>(count))));
+    const float cell = 2.0F / static_cast<float>(side);
+
+    std::vector<InstanceData> instances(count);
+    for (uint32_t i = 0; i < count; i++) {
+        // A cheap integer hash, so that neighbouring instances get visibly different rotations, colors and depths.
+        uint32_t hash = i * 0x9E3779B9U;
+        hash          = (hash ^ (hash >> 16U)) * 0x85EBCA6BU;
+        hash          = hash ^ (hash >> 13U);
+
+        const uint32_t depthHash = hash * 0xC2B2AE35U;
+
+        const float x = -1.0F + (cell * (static_cast<float>(i % side) + 0.5F));
+        const float y = -1.0F + (cell * (static_cast<float>(i / side) + 0.5F));
+
+        instances[i] = { .offset   = { x, y },
+                         .scale    = cell * scale,
+                         .rotation = static_cast<float>(hash & 0xFFFFU) / 65535.0F * 6.2831853F,
+                         .color    = { 0.25F + (0.75F * static_cast<float>((hash >> 8U) & 0xFFU) / 255.0F),
+                                       0.25F + (0.75F * static_cast<float>((hash >> 16U) & 0xFFU) / 255.0F),
+                                       0.25F + (0.75F * static_cast<float>((hash >> 24U) & 0xFFU) / 255.0F) },
+                         .depth    = static_cast<float>(depthHash >> 16U) / 65536.0F };
+    }
+
+    return instances;
+}
+
+// Stable LSD radix sort of the instances by their depth, quantized to a 16-bit key and sorted in two 8-bit passes.
+// Front to back lets the depth test reject the hidden fragments of opaque instances before they are shaded,
+// back to front is the worst case for it and the order blended instances need.
+inline void SortByDepth(std::vector<InstanceData>& instances, bool frontToBack) {
+    constexpr uint32_t kRadixBits = 8;
+    constexpr uint32_t kBuckets   = 1U << kRadixBits;
+
+    const auto key = [frontToBack](const InstanceData& instance) -> uint32_t {
+        const auto depthKey = static_cast<uint32_t>(std::clamp(instance.depth, 0.0F, 1.0F) * 65535.0F);
+        return frontToBack ? depthKey : 0xFFFFU - depthKey;
+    };
+
+    std::vector<InstanceData> sorted(instances.size());
+    for (uint32_t shift = 0; shift < 16; shift += kRadixBits) {
+        std::array<size_t, kBuckets> offsets = {};
+        for (const auto& instance : instances) {
+            offsets[(key(instance) >> shift) & (kBuckets - 1)]++;
+        }
+
+        size_t offset = 0;
+        for (auto& bucket : offsets) {
+            offset += std::exchange(bucket, offset);
+        }
+
+        for (const auto& instance : instances) {
+            sorted[offsets[(key(instance) >> shift) & (kBuckets - 1)]++] = instance;
+        }
+
+        instances.swap(sorted);
+    }
+}
+
+// Camera pushed to triangle.vert and cull.comp, positions end up at '(position - offset) * zoom'.
+struct View {
+    // NOLINTBEGIN(misc-non-private-member-variables-in-classes)
+    glm::vec2 offset;
+    float     zoom;
+    // NOLINTEND(misc-non-private-member-variables-in-classes)
+};
+
+// Push constants of cull.comp.
+struct CullConstants {
+    // NOLINTBEGIN(misc-non-private-member-variables-in-classes)
+    View     view;
+    uint32_t objectCount;
+    uint32_t indexCount;
+    // NOLINTEND(misc-non-private-member-variables-in-classes)
+};
+
+static_assert(sizeof(View) == 12 && sizeof(CullConstants) == 20, "View and CullConstants must match the push constants in triangle.vert and cull.comp.");
+
+// A zoomed in camera circles over the instance grid, so the set of visible instances changes every frame, but always stays within the grid.
+// A zoom of 1 shows the whole grid and never moves.
+inline auto MakeView(uint64_t frameNumber, float zoom) -> View {
+    const float radius = 1.0F - (1.0F / zoom);
+    const float angle  = static_cast<float>(frameNumber % 4096) * (6.2831853F / 4096.0F);
+    return { .offset = { radius * std::cos(angle), radius * std::sin(angle) }, .zoom = zoom };
+}
+
+// Push constants of animate.comp, which lays the instances out like MakeInstanceGrid and animates them by 'phase'.
+struct AnimationConstants {
+    // NOLINTBEGIN(misc-non-private-member-variables-in-classes)
+    uint32_t objectCount;
+    uint32_t side;           // Grid columns.
+    float    cell;           // Grid cell size.
+    float    instanceScale;  // InstanceData::scale before the animation.
+    float    phase;          // Radians, wraps every 4096 frames like MakeView.
+    // NOLINTEND(misc-non-private-member-variables-in-classes)
+};
+
+static_assert(sizeof(AnimationConstants) == 20, "AnimationConstants must match the push constants in animate.comp.");
+
+// All the CPU contributes to the animated instances, the grid is rebuilt on the GPU from these every frame.
+inline auto MakeAnimationConstants(uint32_t count, float scale, uint64_t frameNumber) -> AnimationConstants {
+    const auto  side = count <= 1 ? 1U : static_cast<uint32_t>(std::ceil(std::sqrt(static_cast<double>(count))));
+    const float cell = 2.0F / static_cast<float>(side);
+    return { .objectCount   = count,
+             .side          = side,
+             .cell          = cell,
+             .instanceScale = count <= 1 ? 1.0F : cell * scale,
+             .phase         = static_cast<float>(frameNumber % 4096) * (6.2831853F / 4096.0F) };
+}
+
+// Bounding circle against the view rectangle, the same test as cull.comp.
+inline auto IsVisible(const InstanceData& instance, const View& view) -> bool {
+    const float extent = (1.0F / view.zoom) + (instance.scale * kTriangleBoundingRadius);
+    return std::abs(instance.offset.x - view.offset.x) <= extent && std::abs(instance.offset.y - view.offset.y) <= extent;
+}
+
+}  // namespace vt::geometry
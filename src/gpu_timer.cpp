@@ -0,0 +1,116 @@
+#include "gpu_timer.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <format>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace vt::profiling {
+
+GpuTimer::GpuTimer(VkDevice device, VkPhysicalDevice physicalDevice, uint32_t queueFamilyIndex, uint32_t slotCount)
+    : m_device(device), m_slotRegions(slotCount) {
+    VkPhysicalDeviceProperties properties = {};
+    vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+
+    uint32_t queueFamilyCount = { 0 };
+    vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &queueFamilyCount, nullptr);
+    std::vector<VkQueueFamilyProperties> queueFamilies(queueFamilyCount);
+    vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &queueFamilyCount, queueFamilies.data());
+
+    const uint32_t validBits = queueFamilyIndex < queueFamilyCount ? queueFamilies[queueFamilyIndex].timestampValidBits : 0;
+    if (0 == validBits) {
+        throw std::runtime_error("GpuTimer::GpuTimer: The queue family does not support timestamps.");
+    }
+
+    m_timestampPeriod = static_cast<double>(properties.limits.timestampPeriod);
+    m_timestampMask   = validBits >= 64 ? ~0ULL : (1ULL << validBits) - 1;
+
+    const VkQueryPoolCreateInfo createInfo = { .sType              = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO,
+                                               .pNext              = nullptr,
+                                               .flags              = {},
+                                               .queryType          = VK_QUERY_TYPE_TIMESTAMP,
+                                               .queryCount         = slotCount * kMaxRegions * 2,
+                                               .pipelineStatistics = {} };
+
+    if (const auto& result = vkCreateQueryPool(m_device, &createInfo, nullptr, &m_queryPool) != VK_SUCCESS) {
+        throw std::runtime_error(std::format("GpuTimer::GpuTimer: Failed to create timestamp query pool, error code: {}.", result));
+    }
+}
+
+GpuTimer::~GpuTimer() noexcept {
+    vkDestroyQueryPool(m_device, m_queryPool, nullptr);
+}
+
+void GpuTimer::BeginFrame(VkCommandBuffer commandBuffer, uint32_t slot) {
+    CollectResults(slot);
+
+    m_currentSlot = slot;
+    m_slotRegions[slot].clear();
+    vkCmdResetQueryPool(commandBuffer, m_queryPool, FirstQuery(slot), kMaxRegions * 2);
+}
+
+auto GpuTimer::BeginRegion(VkCommandBuffer commandBuffer, std::string_view name) -> uint32_t {
+    auto& regions = m_slotRegions[m_currentSlot];
+    if (regions.size() >= kMaxRegions) {
+        throw std::runtime_error(std::format("GpuTimer::BeginRegion: More than {} regions in a frame, can't time [{}].", kMaxRegions, name));
+    }
+
+    const auto region = static_cast<uint32_t>(regions.size());
+    regions.emplace_back(name);
+
+    vkCmdWriteTimestamp2(commandBuffer, VK_PIPELINE_STAGE_2_TOP_OF_PIPE_BIT, m_queryPool, FirstQuery(m_currentSlot) + (region * 2));
+    return region;
+}
+
+void GpuTimer::EndRegion(VkCommandBuffer commandBuffer, uint32_t region) {
+    vkCmdWriteTimestamp2(commandBuffer, VK_PIPELINE_STAGE_2_BOTTOM_OF_PIPE_BIT, m_queryPool, FirstQuery(m_currentSlot) + (region * 2) + 1);
+}
+
+void GpuTimer::CollectResults(uint32_t slot) {
+    const auto& regions = m_slotRegions[slot];
+    if (regions.empty()) {
+        return;
+    }
+
+    // Each query is returned as a { value, availability } pair. VK_QUERY_RESULT_WAIT_BIT is deliberately not set,
+    // so the call returns VK_NOT_READY rather than blocking when something is unavailable.
+    const auto                            queryCount = static_cast<uint32_t>(regions.size() * 2);
+    std::array<uint64_t, kMaxRegions * 4> results    = {};
+    const VkResult                        result     = vkGetQueryPoolResults(m_device, m_queryPool, FirstQuery(slot), queryCount, queryCount * 2 * sizeof(uint64_t),
+                                                                             results.data(), 2 * sizeof(uint64_t),
+                                                                             VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WITH_AVAILABILITY_BIT);
+
+    if (VK_SUCCESS != result && VK_NOT_READY != result) {
+        throw std::runtime_error(std::format("GpuTimer::CollectResults: Failed to read timestamps, error code: {}.", static_cast<int32_t>(result)));
+    }
+
+    for (size_t region = 0; region < regions.size(); region++) {
+        const uint64_t begin          = results[region * 4];
+        const bool     beginAvailable = 0 != results[(region * 4) + 1];
+        const uint64_t end            = results[(region * 4) + 2];
+        const bool     endAvailable   = 0 != results[(region * 4) + 3];
+
+        if (!beginAvailable || !endAvailable) {
+            continue;
+        }
+
+        const uint64_t ticks = (end - begin) & m_timestampMask;
+        const double   ms    = static_cast<double>(ticks) * m_timestampPeriod / 1'000'000.0;
+
+        auto stats = std::ranges::find(m_stats, regions[region], &RegionStats::name);
+        if (stats == m_stats.end()) {
+            stats = m_stats.insert(m_stats.end(), RegionStats { .name = regions[region], .lastMs = 0.0, .totalMs = 0.0, .maxMs = 0.0, .samples = 0 });
+        }
+
+        stats->lastMs  = ms;
+        stats->totalMs += ms;
+        stats->maxMs   = std::max(stats->maxMs, ms);
+        stats->samples++;
+    }
+}
+
+}  // namespace vt::profiling
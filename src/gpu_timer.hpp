@@ -0,0 +1,67 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace vt::profiling {
+
+// GPU timestamps around named regions of a frame's command buffer, with one range of queries per frame slot.
+// A slot's results are collected the next time that slot is recorded. By then the frame timeline has already
+// guaranteed that the GPU finished them, so reading never stalls. Results that are somehow still unavailable are skipped, not waited on.
+class GpuTimer {
+  public:
+    struct RegionStats {
+        // NOLINTBEGIN(misc-non-private-member-variables-in-classes)
+        std::string name;
+        double      lastMs  = 0.0;
+        double      totalMs = 0.0;
+        double      maxMs   = 0.0;
+        uint64_t    samples = 0;
+        // NOLINTEND(misc-non-private-member-variables-in-classes)
+
+        [[nodiscard]] auto MeanMs() const -> double { return 0 == samples ? 0.0 : totalMs / static_cast<double>(samples); }
+    };
+
+    static constexpr uint32_t kMaxRegions = 16;  // Per frame, each region uses a begin and an end query.
+
+    GpuTimer(VkDevice device, VkPhysicalDevice physicalDevice, uint32_t queueFamilyIndex, uint32_t slotCount);
+    ~GpuTimer() noexcept;
+
+    // Copy constructor and assignment operator.
+    GpuTimer(const GpuTimer& other)                    = delete;
+    auto operator=(const GpuTimer& other) -> GpuTimer& = delete;
+
+    // Move constructor and move assignment operator.
+    GpuTimer(GpuTimer&& other) noexcept                    = delete;
+    auto operator=(GpuTimer&& other) noexcept -> GpuTimer& = delete;
+
+    // Collects the results the slot recorded last time and resets its queries. Must be recorded outside of a render pass.
+    void BeginFrame(VkCommandBuffer commandBuffer, uint32_t slot);
+
+    // Regions may nest, but BeginRegion and EndRegion must be recorded into the same primary command buffer.
+    auto BeginRegion(VkCommandBuffer commandBuffer, std::string_view name) -> uint32_t;
+    void EndRegion(VkCommandBuffer commandBuffer, uint32_t region);
+
+    // One entry per region name, in the order they were first recorded.
+    [[nodiscard]] auto GetRegionStats() const -> const std::vector<RegionStats>& { return m_stats; }
+
+  private:
+    void CollectResults(uint32_t slot);
+
+    [[nodiscard]] auto FirstQuery(uint32_t slot) const -> uint32_t { return slot * kMaxRegions * 2; }
+
+    VkDevice    m_device          = VK_NULL_HANDLE;
+    VkQueryPool m_queryPool       = VK_NULL_HANDLE;
+    double      m_timestampPeriod = 1.0;  // Nanoseconds per timestamp tick.
+    uint64_t    m_timestampMask   = ~0ULL;
+    uint32_t    m_currentSlot     = 0;
+
+    std::vector<std::vector<std::string>> m_slotRegions;  // Names of the regions recorded into each slot, indexed by region.
+    std::vector<RegionStats>              m_stats;
+};
+
+}  // namespace vt::profiling
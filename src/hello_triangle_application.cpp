@@ -1,7 +1,10 @@
 #include <algorithm>
 #include <array>
+#include <chrono>
+#include <cstddef>
 #include <cstdint>
 #include <cstdlib>
+#include <exception>
 #include <filesystem>
 #include <format>
 #include <iostream>
@@ -13,6 +16,7 @@
 #include <span>
 #include <stdexcept>
 #include <string>
+#include <string_view>
 #include <utility>
 #include <vector>
 
@@ -20,6 +24,15 @@
 #include <GLFW/glfw3.h>
 
 #include "hello_triangle_application.hpp"
+#include "embedded_shaders/animate.comp.hpp"
+#include "embedded_shaders/cull.comp.hpp"
+#include "embedded_shaders/triangle.frag.hpp"
+#include "embedded_shaders/triangle.vert.hpp"
+#include "geometry.hpp"
+#include "pipeline_cache.hpp"
+#include "task_graph.hpp"
+#include "thread_pool.hpp"
+#include "trace.hpp"
 #include "utilities.hpp"
 #include "vulkan_validation.hpp"
 
@@ -29,119 +42,601 @@ namespace vt::triangle {
 void HelloTriangleApplication::InitWindow() {
     glfwInit();
     glfwWindowHint(GLFW_CLIENT_API, GLFW_NO_API);
-    glfwWindowHint(GLFW_RESIZABLE, GLFW_FALSE);
+    glfwWindowHint(GLFW_RESIZABLE, GLFW_TRUE);
 
     m_window = glfwCreateWindow(kWidth, kHeight, "Vulkan", nullptr, nullptr);
+    glfwSetWindowUserPointer(m_window, this);
+    glfwSetFramebufferSizeCallback(m_window, FramebufferResizeCallback);
+}
+
+void HelloTriangleApplication::FramebufferResizeCallback(GLFWwindow* window, int /*width*/, int /*height*/) {
+    // Not every platform reports VK_ERROR_OUT_OF_DATE_KHR on resize, so the resize is tracked explicitly as well.
+    auto* app                 = static_cast<HelloTriangleApplication*>(glfwGetWindowUserPointer(window));
+    app->m_framebufferResized = true;
 }
 
 void HelloTriangleApplication::InitVulkan() {
-    CreateInstance();
-    SetupDebugMessenger();
-    CreateSurface();
-    PickPhysicalDevice();
-    CreateLogicalDevice();
-    CreateSwapchain();
-    CreateImageViews();
-    CreateRenderPass();
-    CreateGraphicsPipeline();
-    CreateFramebuffers();
-    CreateCommandPool();
-    CreateCommandBuffers();
-    CreateSyncObjects();
+    VT_TRACE_ZONE("InitVulkan");
+
+    // Everything up to the logical device is one chain, after that most steps only need the device and a few of the others, e.g.
+    // the pipelines compile while the swap chain is created and the geometry is uploaded. Each step only writes its own members.
+    using Affinity = threading::TaskGraph::Affinity;
+    threading::TaskGraph graph;
+
+    const auto instance       = graph.Add("CreateInstance", {}, [this]() { CreateInstance(); });
+    const auto surface        = m_settings.headless ? instance : graph.Add("CreateSurface", { instance }, [this]() { CreateSurface(); });
+    const auto physicalDevice = graph.Add("PickPhysicalDevice", { surface }, [this]() { PickPhysicalDevice(); });
+    const auto device         = graph.Add("CreateLogicalDevice", { physicalDevice }, [this]() { CreateLogicalDevice(); });
+    const auto allocator      = graph.Add("CreateAllocator", { device }, [this]() { m_allocator = std::make_unique<memory::DeviceAllocator>(m_device, m_physicalDevice); });
+    const auto uploader       = graph.Add("CreateUploader", { allocator }, [this]() { CreateUploader(); });
+
+    // glfwGetFramebufferSize, called through ChooseSwapExtent, may only be called from the main thread.
+    const auto targets = m_settings.headless ? graph.Add("CreateOffscreenTargets", { allocator }, [this]() { CreateOffscreenTargets(); })
+                                             : graph.Add("CreateSwapchain", { device }, [this]() { CreateSwapchain(); }, Affinity::MAIN_THREAD);
+
+    // Whether dynamic rendering is used is only known once the logical device exists, hence the checks inside the steps.
+    const auto imageViews       = graph.Add("CreateImageViews", { targets }, [this]() { CreateImageViews(); });
+    const auto renderPass       = graph.Add("CreateRenderPass", { targets }, [this]() {
+        if (!m_dynamicRendering) {
+            CreateRenderPass();
+        }
+    });
+    const auto setLayouts       = graph.Add("CreateDescriptorSetLayout", { device }, [this]() { CreateDescriptorSetLayout(); });
+    const auto pipelineCache    = graph.Add("CreatePipelineCache", { device }, [this]() { CreatePipelineCache(); });
+    const auto graphicsPipeline = graph.Add("CreateGraphicsPipeline", { renderPass, setLayouts, pipelineCache }, [this]() { CreateGraphicsPipeline(); });
+    const auto depthResources   = graph.Add("CreateDepthResources", { targets, allocator }, [this]() { CreateDepthResources(); });
+    const auto framebuffers     = graph.Add("CreateFramebuffers", { imageViews, depthResources, renderPass }, [this]() {
+        if (!m_dynamicRendering) {
+            CreateFramebuffers();
+        }
+    });
+    const auto commandPool      = graph.Add("CreateCommandPool", { device }, [this]() { CreateCommandPool(); });
+    const auto geometry         = graph.Add("CreateGeometryBuffers", { uploader }, [this]() { CreateGeometryBuffers(); });
+    const auto descriptorSet    = graph.Add("CreateDescriptorSet", { setLayouts, geometry }, [this]() { CreateDescriptorSet(); });
+    const auto commandBuffers   = graph.Add("CreateCommandBuffers", { commandPool, allocator }, [this]() { CreateCommandBuffers(); });
+    const auto syncObjects      = graph.Add("CreateSyncObjects", { commandBuffers, targets }, [this]() { CreateSyncObjects(); });
+    if (!m_settings.capturePath.empty()) {
+        graph.Add("CreateFrameCapture", { syncObjects }, [this]() { CreateFrameCapture(); });
+    }
+
+    std::vector<threading::TaskGraph::TaskId> sceneSteps = { graphicsPipeline, framebuffers, descriptorSet, commandBuffers, syncObjects };
+    if (CullingMode::GPU == m_settings.culling) {
+        sceneSteps.push_back(graph.Add("CreateCullPipeline", { setLayouts, pipelineCache }, [this]() { CreateCullPipeline(); }));
+    }
+    if (m_settings.animateInstances) {
+        sceneSteps.push_back(graph.Add("CreateAnimatePipeline", { setLayouts, pipelineCache }, [this]() { CreateAnimatePipeline(); }));
+    }
+    if (m_settings.gpuStats) {
+        sceneSteps.push_back(graph.Add("CreateGpuTimer", { commandBuffers }, [this]() { CreateGpuTimer(); }));
+    }
+    if (m_settings.overdrawStats) {
+        sceneSteps.push_back(graph.Add("CreateOverdrawCounter", { commandBuffers }, [this]() { CreateOverdrawCounter(); }));
+    }
+    if (m_settings.staticScene) {
+        graph.Add("RecordStaticCommandBuffers", sceneSteps, [this]() { RecordStaticCommandBuffers(); });
+    }
+
+    const auto startTime = std::chrono::steady_clock::now();
+    graph.Run(m_settings.initThreads);
+    m_startupTimeline = graph.GetTimings();
+
+    PrintStartupTimeline(startTime, std::chrono::steady_clock::now());
+}
+
+void HelloTriangleApplication::PrintStartupTimeline(std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point end) const {
+    using Milliseconds = std::chrono::duration<double, std::milli>;
+
+    std::string timeline;
+    for (const auto& step : m_startupTimeline) {
+        timeline += std::format("    {:>8.3f} - {:>8.3f} ms  thread {}  {}\n", Milliseconds(step.begin - start).count(), Milliseconds(step.end - start).count(),
+                                step.thread, step.name);
+    }
+
+    std::cout << std::format("{}::InitVulkan: {} steps on {} thread(s) in {:.3f} ms:\n{}", kClassName, m_startupTimeline.size(), m_settings.initThreads + 1,
+                             Milliseconds(end - start).count(), timeline);
 }
 
 void HelloTriangleApplication::MainLoop() {
-    while (0 == glfwWindowShouldClose(m_window)) {
-        glfwPollEvents();
+    const auto startTime  = std::chrono::steady_clock::now();
+    const auto startFrame = m_frameNumber;
+
+    std::chrono::nanoseconds inputToPresentSum = {};
+    std::chrono::nanoseconds inputToPresentMax = {};
+
+    while (PollEvents()) {
+        if (0 != m_settings.maxFrames && m_frameNumber - startFrame >= m_settings.maxFrames) {
+            break;
+        }
+
         DrawFrame();
+        inputToPresentSum += m_lastFrameTimings.inputToPresent;
+        inputToPresentMax  = std::max(inputToPresentMax, m_lastFrameTimings.inputToPresent);
+    }
+
+    WaitIdle();
+
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - startTime;
+    const uint64_t                      frames  = m_frameNumber - startFrame;
+    if (elapsed.count() > 0.0) {
+        const double triangles = static_cast<double>(frames) * static_cast<double>(GetTrianglesPerFrame());
+        std::cout << std::format("{}::MainLoop: {} frames in {:.2f} s ({:.1f} FPS, {:.3g} triangles/s) with {} frame(s) in flight.\n", kClassName, frames,
+                                 elapsed.count(), static_cast<double>(frames) / elapsed.count(), triangles / elapsed.count(), m_frames.size());
+    }
+
+    if (!m_settings.headless && frames > 0) {
+        using Milliseconds = std::chrono::duration<double, std::milli>;
+        std::cout << std::format("{}::MainLoop: {} with {} swap chain image(s), input to present latency {:.2f} ms mean, {:.2f} ms max.\n", kClassName,
+                                 utilities::PresentModeName(m_presentMode), m_swapChainImages.size(),
+                                 Milliseconds(inputToPresentSum).count() / static_cast<double>(frames), Milliseconds(inputToPresentMax).count());
+    }
+
+    const auto memoryStats = m_allocator->GetStats();
+    std::cout << std::format("{}::MainLoop: {} allocation(s) in {} device memory block(s), {:.2f}/{:.2f} MiB used, {:.1f}% fragmented.\n", kClassName,
+                             memoryStats.allocationCount, memoryStats.deviceAllocationCount, static_cast<double>(memoryStats.usedBytes) / (1024.0 * 1024.0),
+                             static_cast<double>(memoryStats.blockBytes) / (1024.0 * 1024.0), memoryStats.Fragmentation() * 100.0);
+
+    const auto& uploadStats = m_uploader->GetStats();
+    std::cout << std::format("{}::MainLoop: {:.2f} MiB uploaded in {} submission(s) on the {} queue, {} staging ring stall(s).\n", kClassName,
+                             static_cast<double>(uploadStats.uploadedBytes) / (1024.0 * 1024.0), uploadStats.submissions,
+                             uploadStats.dedicatedQueue ? "transfer" : "graphics", uploadStats.ringStalls);
+
+    if (nullptr != m_frameCapture) {
+        const auto captureStats = GetCaptureStats();
+        std::cout << std::format("{}::MainLoop: {} frame(s) captured, {} written ({:.2f} MiB, {:.3f} ms max), {} failed, {} dropped while the writer was behind.\n",
+                                 kClassName, captureStats.captured, captureStats.written, static_cast<double>(captureStats.writtenBytes) / (1024.0 * 1024.0),
+                                 std::chrono::duration<double, std::milli>(captureStats.maxWriteTime).count(), captureStats.failed, captureStats.dropped);
+    }
+
+    if (0 != m_settings.colorModeCycle) {
+        const auto variantStats = m_pipelineVariants->GetStats();
+        std::cout << std::format("{}::MainLoop: {} pipeline variant(s) compiled in the background ({:.3f} ms max), {} failed, {} fallback frame(s).\n",
+                                 kClassName, variantStats.compiled, std::chrono::duration<double, std::milli>(variantStats.maxCompileTime).count(),
+                                 variantStats.failed, m_fallbackFrames);
+    }
+
+    if (nullptr != m_gpuTimer) {
+        PrintGpuStats();
+    }
+
+    if (nullptr != m_overdrawCounter) {
+        const auto& overdrawStats = m_overdrawCounter->GetStats();
+        std::cout << std::format("{}::MainLoop: {:.3g} fragments shaded per frame, overdraw {:.2f} mean, {:.2f} max over {} frames, {}.\n", kClassName,
+                                 overdrawStats.MeanInvocations(), overdrawStats.MeanOverdraw(), overdrawStats.maxOverdraw, overdrawStats.frames,
+                                 UsesDepthBuffer() ? "depth tested" : "without a depth test");
+    }
+}
+
+auto HelloTriangleApplication::PollEvents() -> bool {
+    m_lastPollTime = std::chrono::steady_clock::now();
+
+    if (!m_settings.tracePath.empty() && trace::ConsumeDumpRequest()) {
+        trace::WriteChromeTrace(m_settings.tracePath);
+    }
+
+    if (m_settings.headless) {
+        return true;
     }
 
-    vkDeviceWaitIdle(m_device);
+    VT_TRACE_ZONE("PollEvents");
+    glfwPollEvents();
+    return 0 == glfwWindowShouldClose(m_window);
 }
 
 void HelloTriangleApplication::DrawFrame() {
     // Common steps:
-    //  - Wait for the previous frame to finish
+    //  - Wait for the frame that last used this slot to finish, the other slots may still be in flight
+    //  - Submit the frame's uploads, which the frame's submission waits for on the GPU only
     //  - Acquire an image from the swap chain
     //  - Record a command buffer which draws the scene onto that image
-    //  - Submit the recorded command buffer
+    //  - Submit the recorded command buffer, together with any other work queued for this frame
     //  - Present the swap chain image
-    vkWaitForFences(m_device, 1, &m_inFlightFence, VK_TRUE, UINT64_MAX);
-    vkResetFences(m_device, 1, &m_inFlightFence);
-
-    uint32_t imageIndex = { 0 };
-    vkAcquireNextImageKHR(m_device, m_swapChain, UINT64_MAX, m_imageAvailableSemaphore, VK_NULL_HANDLE, &imageIndex);
-    vkResetCommandBuffer(m_commandBuffer, /*VkCommandBufferResetFlagBits*/ 0);
-    RecordCommandBuffer(m_commandBuffer, imageIndex);
-
-    // Each entry in the waitStages array corresponds to the semaphore with the same index in pWaitSemaphores.
-    std::array<VkSemaphore, 1>          waitSemaphores   = { m_imageAvailableSemaphore };
-    std::array<VkSemaphore, 1>          signalSemaphores = { m_renderFinishedSemaphore };
-    std::array<VkPipelineStageFlags, 1> waitStages       = { VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT };
-    const VkSubmitInfo                  submitInfo       = { .sType                = VK_STRUCTURE_TYPE_SUBMIT_INFO,
-                                                             .pNext                = nullptr,
-                                                             .waitSemaphoreCount   = 1,
-                                                             .pWaitSemaphores      = waitSemaphores.data(),
-                                                             .pWaitDstStageMask    = waitStages.data(),
-                                                             .commandBufferCount   = 1,
-                                                             .pCommandBuffers      = &m_commandBuffer,
-                                                             .signalSemaphoreCount = 1,
-                                                             .pSignalSemaphores    = signalSemaphores.data() };
-
-    if (const auto& result = vkQueueSubmit(m_graphicsQueue, 1, &submitInfo, m_inFlightFence) != VK_SUCCESS) {
-        throw std::runtime_error(std::format("{}::DrawFrame: Failed to submit draw command buffer, error code: {}.", kClassName, result));
-    }
-
-    std::array<VkSwapchainKHR, 1> swapChains  = { m_swapChain };
-    const VkPresentInfoKHR        presentInfo = {
-               .sType              = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR,
-               .pNext              = nullptr,
-               .waitSemaphoreCount = 1,
-               .pWaitSemaphores    = signalSemaphores.data(),
-               .swapchainCount     = 1,
-               .pSwapchains        = swapChains.data(),
-               .pImageIndices      = &imageIndex,
-               .pResults           = nullptr  // Optional
-    };
+    using Clock = std::chrono::steady_clock;
+    const auto frameStart = Clock::now();
+
+    FrameData& frame = CurrentFrame();
+    WaitForFrameSlot();
+    ReleaseRetiredSwapchains(false);
+    const auto frameWaitDone = Clock::now();
+
+    // Uploads are submitted before recording, so the transfer queue copies while the CPU records the frame.
+    if (0 != m_settings.uploadStreamKiB) {
+        const VkDeviceSize slotSize = m_streamData.size();
+        m_uploader->Upload(m_streamBuffer.buffer, CurrentFrameIndex() * slotSize, m_streamData, VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT,
+                           VK_ACCESS_2_SHADER_STORAGE_READ_BIT);
+    }
+    m_uploader->Flush();
+    const auto uploadDone = Clock::now();
+
+    // Headless targets are owned one-to-one by the frame slots, so the wait above already guarantees the image is free.
+    uint32_t                 imageIndex   = { 0 };
+    std::chrono::nanoseconds recreateTime = {};
+    if (m_settings.headless) {
+        imageIndex = static_cast<uint32_t>(m_frameNumber % m_swapChainImages.size());
+    } else {
+        VkResult result = vkAcquireNextImageKHR(m_device, m_swapChain, UINT64_MAX, frame.imageAvailableSemaphore, VK_NULL_HANDLE, &imageIndex);
+
+        // An out of date swap chain can't be rendered to at all, recreate it and try again within the same frame.
+        while (VK_ERROR_OUT_OF_DATE_KHR == result) {
+            const auto recreateStart = Clock::now();
+            RecreateSwapchain();
+            recreateTime += Clock::now() - recreateStart;
+
+            result = vkAcquireNextImageKHR(m_device, m_swapChain, UINT64_MAX, frame.imageAvailableSemaphore, VK_NULL_HANDLE, &imageIndex);
+        }
+
+        if (VK_SUCCESS != result && VK_SUBOPTIMAL_KHR != result) {
+            throw std::runtime_error(std::format("{}::DrawFrame: Failed to acquire swap chain image, error code: {}.", kClassName, static_cast<int32_t>(result)));
+        }
+    }
+    const auto acquireDone = Clock::now();
+
+    // A static scene never changes between frames, so the per image command buffer recorded up front is submitted as is.
+    VkCommandBuffer commandBuffer = frame.commandBuffer;
+    if (m_settings.staticScene) {
+        commandBuffer = m_staticCommandBuffers[imageIndex];
+    } else if (nullptr != m_recordThreadPool) {
+        m_framePipeline = SelectGraphicsPipeline();
+        vkResetCommandBuffer(commandBuffer, /*VkCommandBufferResetFlagBits*/ 0);
+        RecordCommandBufferParallel(frame, imageIndex);
+    } else {
+        m_framePipeline = SelectGraphicsPipeline();
+        vkResetCommandBuffer(commandBuffer, /*VkCommandBufferResetFlagBits*/ 0);
+        RecordCommandBuffer(commandBuffer, imageIndex);
+    }
+    const auto recordDone = Clock::now();
+
+    // The swap chain image is only needed once color output starts, so work queued ahead of the draw (uploads, compute) is not held back by it.
+    if (m_uploader->HasPendingAcquires()) {
+        QueueUploadAcquire(frame);
+    }
+    QueueCommandBuffer(commandBuffer);
+    if (nullptr != m_frameCapture) {
+        QueueFrameCapture(frame, imageIndex);
+    }
+    if (!m_settings.headless) {
+        QueueSemaphoreWait(frame.imageAvailableSemaphore, 0, VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT);
+    }
+
+    // A failed submit never copies the captured frame, its readback buffer would otherwise stay busy and Drain would wait for it forever.
+    try {
+        SubmitFrame(m_settings.headless ? VK_NULL_HANDLE : m_renderFinishedSemaphores[imageIndex]);
+    } catch (...) {
+        if (nullptr != m_frameCapture) {
+            m_frameCapture->Abandon();
+        }
+        throw;
+    }
+    if (nullptr != m_frameCapture) {
+        m_frameCapture->Commit();
+    }
+    const auto submitDone = Clock::now();
+
+    if (!m_settings.headless) {
+        std::array<VkSwapchainKHR, 1> swapChains  = { m_swapChain };
+        const VkPresentInfoKHR        presentInfo = {
+                   .sType              = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR,
+                   .pNext              = nullptr,
+                   .waitSemaphoreCount = 1,
+                   .pWaitSemaphores    = &m_renderFinishedSemaphores[imageIndex],
+                   .swapchainCount     = 1,
+                   .pSwapchains        = swapChains.data(),
+                   .pImageIndices      = &imageIndex,
+                   .pResults           = nullptr  // Optional
+        };
+
+        const VkResult result = vkQueuePresentKHR(m_presentQueue, &presentInfo);
+
+        // The frame is counted as submitted before recreating, so the current swap chain is retired after this frame as well.
+        m_frameNumber++;
+
+        if (VK_ERROR_OUT_OF_DATE_KHR == result || VK_SUBOPTIMAL_KHR == result || m_framebufferResized) {
+            const auto recreateStart = Clock::now();
+            RecreateSwapchain();
+            recreateTime += Clock::now() - recreateStart;
+        } else if (VK_SUCCESS != result) {
+            throw std::runtime_error(std::format("{}::DrawFrame: Failed to present image, error code: {}.", kClassName, static_cast<int32_t>(result)));
+        }
+    } else {
+        m_frameNumber++;
+    }
+    const auto presentDone = Clock::now();
+
+    // Without a PollEvents call before the frame there is no input to measure from.
+    const auto inputToPresent = m_lastPollTime.time_since_epoch().count() > 0 ? presentDone - m_lastPollTime : std::chrono::nanoseconds {};
+
+    m_lastFrameTimings = { .frameWait      = frameWaitDone - frameStart,
+                           .upload         = uploadDone - frameWaitDone,
+                           .acquire        = acquireDone - uploadDone,
+                           .record         = recordDone - acquireDone,
+                           .submit         = submitDone - recordDone,
+                           .present        = presentDone - submitDone,
+                           .recreate       = recreateTime,
+                           .total          = presentDone - frameStart,
+                           .inputToPresent = inputToPresent };
+
+    // The steps are already timed above, so the trace reuses those time points instead of nesting zones.
+    trace::RecordZone("DrawFrame", frameStart, presentDone);
+    trace::RecordZone("FrameWait", frameStart, frameWaitDone);
+    trace::RecordZone("Upload", frameWaitDone, uploadDone);
+    trace::RecordZone("Acquire", uploadDone, acquireDone);
+    trace::RecordZone("Record", acquireDone, recordDone);
+    trace::RecordZone("Submit", recordDone, submitDone);
+    trace::RecordZone("Present", submitDone, presentDone);
+}
+
+void HelloTriangleApplication::WaitForFrameSlot() {
+    // Frame N signals the value N + 1 on the frame timeline, so the slot of the current frame is free
+    // once the frame that used it 'framesInFlight' frames ago has signaled.
+    const uint64_t framesInFlight = m_frames.size();
+    if (m_frameNumber < framesInFlight) {
+        return;
+    }
+
+    const uint64_t            waitValue = m_frameNumber + 1 - framesInFlight;
+    const VkSemaphoreWaitInfo waitInfo  = { .sType          = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO,
+                                            .pNext          = nullptr,
+                                            .flags          = {},
+                                            .semaphoreCount = 1,
+                                            .pSemaphores    = &m_frameTimeline,
+                                            .pValues        = &waitValue };
+
+    if (const auto& result = vkWaitSemaphores(m_device, &waitInfo, UINT64_MAX) != VK_SUCCESS) {
+        throw std::runtime_error(std::format("{}::WaitForFrameSlot: Failed to wait for the frame timeline, error code: {}.", kClassName, result));
+    }
+}
+
+void HelloTriangleApplication::QueueUploadAcquire(FrameData& frame) {
+    // The graphics half of the upload handover goes into a command buffer of its own, which also works for pre-recorded static scenes.
+    vkResetCommandBuffer(frame.acquireCommandBuffer, /*VkCommandBufferResetFlagBits*/ 0);
+
+    const VkCommandBufferBeginInfo beginInfo = { .sType            = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+                                                 .pNext            = nullptr,
+                                                 .flags            = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT,
+                                                 .pInheritanceInfo = nullptr };
+
+    if (const auto& result = vkBeginCommandBuffer(frame.acquireCommandBuffer, &beginInfo) != VK_SUCCESS) {
+        throw std::runtime_error(std::format("{}::QueueUploadAcquire: Failed to begin recording command buffer, error code: {}.", kClassName, result));
+    }
+
+    const auto handover = m_uploader->RecordAcquire(frame.acquireCommandBuffer);
+
+    if (const auto& result = vkEndCommandBuffer(frame.acquireCommandBuffer) != VK_SUCCESS) {
+        throw std::runtime_error(std::format("{}::QueueUploadAcquire: Failed to end command buffer, error code: {}.", kClassName, result));
+    }
+
+    QueueCommandBuffer(frame.acquireCommandBuffer);
+    QueueSemaphoreWait(m_uploader->GetTimeline(), handover.value, handover.stageMask);
+}
+
+void HelloTriangleApplication::CreateFrameCapture() {
+    VT_TRACE_ZONE("CreateFrameCapture");
+
+    m_frameCapture = std::make_unique<capture::FrameCapture>(m_device, *m_allocator, m_frameTimeline,
+                                                             capture::FrameCapture::Config { .format      = m_settings.captureFormat,
+                                                                                             .path        = m_settings.capturePath,
+                                                                                             .extent      = m_swapChainExtent,
+                                                                                             .imageFormat = m_swapChainImageFormat,
+                                                                                             .bufferCount = m_settings.captureBuffers });
+}
+
+void HelloTriangleApplication::QueueFrameCapture(FrameData& frame, uint32_t imageIndex) {
+    // Like the upload acquire, the copy goes into a command buffer of its own, which also works for pre-recorded static scenes.
+    // It runs after the frame's draws in the same submission, so the frame timeline value of the frame covers it as well.
+    vkResetCommandBuffer(frame.captureCommandBuffer, /*VkCommandBufferResetFlagBits*/ 0);
+
+    const VkCommandBufferBeginInfo beginInfo = { .sType            = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+                                                 .pNext            = nullptr,
+                                                 .flags            = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT,
+                                                 .pInheritanceInfo = nullptr };
+
+    if (const auto& result = vkBeginCommandBuffer(frame.captureCommandBuffer, &beginInfo) != VK_SUCCESS) {
+        throw std::runtime_error(std::format("{}::QueueFrameCapture: Failed to begin recording command buffer, error code: {}.", kClassName, result));
+    }
+
+    const bool captured = m_frameCapture->Record(frame.captureCommandBuffer, m_swapChainImages[imageIndex], FinalImageLayout(), m_frameNumber, m_frameNumber + 1);
+
+    if (const auto& result = vkEndCommandBuffer(frame.captureCommandBuffer) != VK_SUCCESS) {
+        throw std::runtime_error(std::format("{}::QueueFrameCapture: Failed to end command buffer, error code: {}.", kClassName, result));
+    }
+
+    // A dropped frame has nothing to submit.
+    if (captured) {
+        QueueCommandBuffer(frame.captureCommandBuffer);
+    }
+}
+
+void HelloTriangleApplication::QueueCommandBuffer(VkCommandBuffer commandBuffer) {
+    m_pendingCommandBuffers.push_back({ .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_SUBMIT_INFO, .pNext = nullptr, .commandBuffer = commandBuffer, .deviceMask = 0 });
+}
+
+void HelloTriangleApplication::QueueSemaphoreWait(VkSemaphore semaphore, uint64_t value, VkPipelineStageFlags2 stageMask) {
+    m_pendingWaitSemaphores.push_back({ .sType       = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO,
+                                        .pNext       = nullptr,
+                                        .semaphore   = semaphore,
+                                        .value       = value,
+                                        .stageMask   = stageMask,
+                                        .deviceIndex = 0 });
+}
+
+void HelloTriangleApplication::SubmitFrame(VkSemaphore renderFinishedSemaphore) {
+    // Everything queued for the frame goes out in a single vkQueueSubmit2, which also advances the frame timeline.
+    std::array<VkSemaphoreSubmitInfo, 2> signalSemaphores = { { { .sType       = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO,
+                                                                  .pNext       = nullptr,
+                                                                  .semaphore   = m_frameTimeline,
+                                                                  .value       = m_frameNumber + 1,
+                                                                  .stageMask   = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT,
+                                                                  .deviceIndex = 0 },
+                                                                { .sType       = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO,
+                                                                  .pNext       = nullptr,
+                                                                  .semaphore   = renderFinishedSemaphore,
+                                                                  .value       = 0,
+                                                                  .stageMask   = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT,
+                                                                  .deviceIndex = 0 } } };
+
+    const VkSubmitInfo2 submitInfo = { .sType                    = VK_STRUCTURE_TYPE_SUBMIT_INFO_2,
+                                       .pNext                    = nullptr,
+                                       .flags                    = {},
+                                       .waitSemaphoreInfoCount   = static_cast<uint32_t>(m_pendingWaitSemaphores.size()),
+                                       .pWaitSemaphoreInfos      = m_pendingWaitSemaphores.data(),
+                                       .commandBufferInfoCount   = static_cast<uint32_t>(m_pendingCommandBuffers.size()),
+                                       .pCommandBufferInfos      = m_pendingCommandBuffers.data(),
+                                       .signalSemaphoreInfoCount = VK_NULL_HANDLE == renderFinishedSemaphore ? 1U : 2U,
+                                       .pSignalSemaphoreInfos    = signalSemaphores.data() };
+
+    const VkResult result = vkQueueSubmit2(m_graphicsQueue, 1, &submitInfo, VK_NULL_HANDLE);
+
+    m_pendingWaitSemaphores.clear();
+    m_pendingCommandBuffers.clear();
+
+    if (VK_SUCCESS != result) {
+        throw std::runtime_error(std::format("{}::SubmitFrame: Failed to submit frame, error code: {}.", kClassName, static_cast<int32_t>(result)));
+    }
+}
+
+auto HelloTriangleApplication::GetGpuStats() const -> std::vector<profiling::GpuTimer::RegionStats> {
+    return nullptr != m_gpuTimer ? m_gpuTimer->GetRegionStats() : std::vector<profiling::GpuTimer::RegionStats> {};
+}
+
+auto HelloTriangleApplication::GetOverdrawStats() const -> profiling::OverdrawCounter::Stats {
+    return nullptr != m_overdrawCounter ? m_overdrawCounter->GetStats() : profiling::OverdrawCounter::Stats {};
+}
+
+auto HelloTriangleApplication::GetCaptureStats() const -> capture::FrameCapture::Stats {
+    if (nullptr == m_frameCapture) {
+        return {};
+    }
+
+    m_frameCapture->Drain();
+    return m_frameCapture->GetStats();
+}
 
-    if (const auto& result = vkQueuePresentKHR(m_presentQueue, &presentInfo) != VK_SUCCESS) {
-        throw std::runtime_error(std::format("{}::DrawFrame: Failed to present image, error code: {}.", kClassName, result));
+auto HelloTriangleApplication::GetTrianglesPerFrame() const -> uint64_t {
+    const uint64_t drawCount = CullingMode::NONE == m_settings.culling ? m_settings.drawCount : 1;
+    return drawCount * m_settings.instanceCount * (geometry::kTriangleIndices.size() / 3);
+}
+
+void HelloTriangleApplication::WaitIdle() const {
+    // Only this renderer's queues, vkDeviceWaitIdle would need every queue of a shared device to be externally synchronized.
+    vkQueueWaitIdle(m_graphicsQueue);
+    if (m_presentQueue != m_graphicsQueue) {
+        vkQueueWaitIdle(m_presentQueue);
     }
+    if (m_transferQueue != m_graphicsQueue && m_transferQueue != m_presentQueue) {
+        vkQueueWaitIdle(m_transferQueue);
+    }
+}
+
+auto HelloTriangleApplication::GetCompletedFrameCount() const -> uint64_t {
+    uint64_t value = { 0 };
+    vkGetSemaphoreCounterValue(m_device, m_frameTimeline, &value);
+    return value;
 }
 
 void HelloTriangleApplication::Cleanup() {
-    vkDestroySemaphore(m_device, m_renderFinishedSemaphore, nullptr);
-    vkDestroySemaphore(m_device, m_imageAvailableSemaphore, nullptr);
-    vkDestroyFence(m_device, m_inFlightFence, nullptr);
+    // Writes the frames still queued, it waits on the frame timeline and reads from the allocator, which are destroyed below.
+    m_frameCapture.reset();
+
+    ReleaseRetiredSwapchains(true);
+
+    for (auto* semaphore : m_renderFinishedSemaphores) {
+        vkDestroySemaphore(m_device, semaphore, nullptr);
+    }
+
+    vkDestroySemaphore(m_device, m_frameTimeline, nullptr);
+    m_gpuTimer.reset();
+    m_overdrawCounter.reset();
+
+    for (auto& frame : m_frames) {
+        vkDestroySemaphore(m_device, frame.imageAvailableSemaphore, nullptr);
+
+        for (auto* commandPool : frame.workerCommandPools) {
+            vkDestroyCommandPool(m_device, commandPool, nullptr);
+        }
+    }
+
+    m_recordThreadPool.reset();
 
     vkDestroyCommandPool(m_device, m_commandPool, nullptr);
 
+    vkDestroyDescriptorPool(m_device, m_descriptorPool, nullptr);
+    m_uploader.reset();
+    m_allocator->DestroyBuffer(m_streamBuffer);
+    m_allocator->DestroyBuffer(m_drawCountBuffer);
+    m_allocator->DestroyBuffer(m_drawCommandBuffer);
+    m_allocator->DestroyBuffer(m_instanceBuffer);
+    m_allocator->DestroyBuffer(m_indexBuffer);
+    m_allocator->DestroyBuffer(m_vertexBuffer);
+
     for (auto* framebuffer : m_swapChainFramebuffers) {
         vkDestroyFramebuffer(m_device, framebuffer, nullptr);
     }
 
+    // Joins the compile thread first, it may still be writing into the pipeline cache.
+    m_pipelineVariants.reset();
+
+    SavePipelineCache();
+    vkDestroyPipelineCache(m_device, m_pipelineCache, nullptr);
+
+    vkDestroyPipeline(m_device, m_animatePipeline, nullptr);
+    vkDestroyPipelineLayout(m_device, m_animatePipelineLayout, nullptr);
+
+    vkDestroyPipeline(m_device, m_cullPipeline, nullptr);
+    vkDestroyPipelineLayout(m_device, m_cullPipelineLayout, nullptr);
+    vkDestroyDescriptorSetLayout(m_device, m_cullDescriptorSetLayout, nullptr);
+
     vkDestroyPipeline(m_device, m_graphicsPipeline, nullptr);
     vkDestroyPipelineLayout(m_device, m_pipelineLayout, nullptr);
+    vkDestroyDescriptorSetLayout(m_device, m_descriptorSetLayout, nullptr);
     vkDestroyRenderPass(m_device, m_renderPass, nullptr);
 
     for (auto* imageView : m_swapChainImageViews) {
         vkDestroyImageView(m_device, imageView, nullptr);
     }
 
-    vkDestroySwapchainKHR(m_device, m_swapChain, nullptr);
-    vkDestroyDevice(m_device, nullptr);
+    if (VK_NULL_HANDLE != m_depthImage.image) {
+        vkDestroyImageView(m_device, m_depthImageView, nullptr);
+        m_allocator->DestroyImage(m_depthImage);
+    }
 
-    if (kEnableValidationLayers) {
-        validation::DestroyDebugUtilsMessengerEXT(m_instance, m_debugMessenger, nullptr);
+    if (m_settings.headless) {
+        for (size_t i = 0; i < m_swapChainImages.size(); i++) {
+            m_allocator->DestroyImage({ .image = m_swapChainImages[i], .allocation = m_offscreenImageAllocations[i] });
+        }
+    } else {
+        vkDestroySwapchainKHR(m_device, m_swapChain, nullptr);
+    }
+
+    m_allocator.reset();
+    if (m_ownsDevice) {
+        vkDestroyDevice(m_device, nullptr);
+    }
+
+    if (!m_settings.headless) {
+        vkDestroySurfaceKHR(m_instance, m_surface, nullptr);
+    }
+
+    // The instance and a shared device go with the context, once every renderer using it has cleaned up.
+    m_context.reset();
+
+    if (!m_settings.tracePath.empty()) {
+        trace::WriteChromeTrace(m_settings.tracePath);
     }
 
-    vkDestroySurfaceKHR(m_instance, m_surface, nullptr);
-    vkDestroyInstance(m_instance, nullptr);
-    glfwDestroyWindow(m_window);
-    glfwTerminate();
+    if (!m_settings.headless) {
+        glfwDestroyWindow(m_window);
+        glfwTerminate();
+    }
 }
 
 void HelloTriangleApplication::CreateInstance() {
+    VT_TRACE_ZONE("CreateInstance");
+
+    m_instance = m_context->GetInstance([this]() { return CreateVulkanInstance(); });
+}
+
+auto HelloTriangleApplication::CreateVulkanInstance() -> VulkanContext::Instance {
+    VulkanContext::Instance instance = {};
+
     // AppInfo initializaton.
     const VkApplicationInfo appInfo = { .sType              = VK_STRUCTURE_TYPE_APPLICATION_INFO,
                                         .pNext              = nullptr,
@@ -149,7 +644,7 @@ void HelloTriangleApplication::CreateInstance() {
                                         .applicationVersion = VK_MAKE_VERSION(1, 0, 0),
                                         .pEngineName        = "No Engine",
                                         .engineVersion      = VK_MAKE_VERSION(1, 0, 0),
-                                        .apiVersion         = VK_API_VERSION_1_0 };
+                                        .apiVersion         = VK_API_VERSION_1_3 };
 
     // CreateInfo initialization and extensions.
     const auto& extensions = GetRequiredExtensions();
@@ -169,19 +664,40 @@ void HelloTriangleApplication::CreateInstance() {
     if (kEnableValidationLayers) {
         CheckValidationLayerSupport();
 
+        instance.validationLog = std::make_unique<validation::MessageLog>(validation::MessageLog::Config {
+            .minSeverity       = m_settings.validationSeverity,
+            .types             = static_cast<VkDebugUtilsMessageTypeFlagsEXT>(VK_DEBUG_UTILS_MESSAGE_TYPE_GENERAL_BIT_EXT) |
+                                 static_cast<VkDebugUtilsMessageTypeFlagsEXT>(VK_DEBUG_UTILS_MESSAGE_TYPE_VALIDATION_BIT_EXT) |
+                                 static_cast<VkDebugUtilsMessageTypeFlagsEXT>(VK_DEBUG_UTILS_MESSAGE_TYPE_PERFORMANCE_BIT_EXT),
+            .repeatLimit       = m_settings.validationRepeatLimit,
+            .messagesPerSecond = m_settings.validationRateLimit });
+
         createInfo.enabledLayerCount   = static_cast<uint32_t>(m_validationLayers.size());
         createInfo.ppEnabledLayerNames = m_validationLayers.data();
 
-        debugCreateInfo  = PopulateDebugMessengerCreateInfo();
+        debugCreateInfo  = PopulateDebugMessengerCreateInfo(instance.validationLog.get());
         createInfo.pNext = debugCreateInfo.get();
     }
 
-    if (const auto& result = vkCreateInstance(&createInfo, nullptr, &m_instance) != VK_SUCCESS) {
-        throw std::runtime_error(std::format("{}::CreateInstance: Failed to create instance, error code: {}.", kClassName, result));
+    if (const auto& result = vkCreateInstance(&createInfo, nullptr, &instance.instance) != VK_SUCCESS) {
+        throw std::runtime_error(std::format("{}::CreateVulkanInstance: Failed to create instance, error code: {}.", kClassName, result));
     }
+
+    SetupDebugMessenger(instance);
+    return instance;
 }
 
 auto HelloTriangleApplication::GetRequiredExtensions() -> std::vector<const char*> {
+    // Headless rendering never creates a surface, so GLFW (and its window system extensions) is not needed at all.
+    if (m_settings.headless) {
+        std::vector<const char*> extensions = {};
+        if (kEnableValidationLayers) {
+            extensions.push_back(VK_EXT_DEBUG_UTILS_EXTENSION_NAME);
+        }
+
+        return extensions;
+    }
+
     uint32_t     glfwExtensionCount = 0;
     const char** glfwExtensions     = glfwGetRequiredInstanceExtensions(&glfwExtensionCount);
 
@@ -204,41 +720,54 @@ auto HelloTriangleApplication::GetRequiredExtensions() -> std::vector<const char
     return extensions;
 }
 
-void HelloTriangleApplication::SetupDebugMessenger() {
+auto HelloTriangleApplication::GetRequiredDeviceExtensions() const -> std::vector<const char*> {
+    if (m_settings.headless) {
+        return {};
+    }
+
+    return { VK_KHR_SWAPCHAIN_EXTENSION_NAME };
+}
+
+void HelloTriangleApplication::SetupDebugMessenger(VulkanContext::Instance& instance) {
+    VT_TRACE_ZONE("SetupDebugMessenger");
+
     if (!kEnableValidationLayers) {
         return;
     }
 
-    auto createInfo = PopulateDebugMessengerCreateInfo();
-    if (const auto& result = validation::vkCreateDebugUtilsMessengerEXT(m_instance, createInfo.get(), nullptr, &m_debugMessenger) != VK_SUCCESS) {
+    auto createInfo = PopulateDebugMessengerCreateInfo(instance.validationLog.get());
+    if (const auto& result = validation::vkCreateDebugUtilsMessengerEXT(instance.instance, createInfo.get(), nullptr, &instance.debugMessenger) != VK_SUCCESS) {
         throw std::runtime_error(std::format("{}::SetupDebugMessenger: Failed to set up debug messenger, error code: {}.", kClassName, result));
     }
 }
 
-auto HelloTriangleApplication::PopulateDebugMessengerCreateInfo() -> std::shared_ptr<VkDebugUtilsMessengerCreateInfoEXT> {
+auto HelloTriangleApplication::PopulateDebugMessengerCreateInfo(validation::MessageLog* log) -> std::shared_ptr<VkDebugUtilsMessengerCreateInfoEXT> {
     auto createInfo             = std::make_shared<VkDebugUtilsMessengerCreateInfoEXT>();
     createInfo->sType           = static_cast<VkStructureType>(VK_STRUCTURE_TYPE_DEBUG_UTILS_MESSENGER_CREATE_INFO_EXT);
-    createInfo->messageSeverity = static_cast<VkDebugUtilsMessageSeverityFlagsEXT>(VK_DEBUG_UTILS_MESSAGE_SEVERITY_VERBOSE_BIT_EXT) |
-                                  static_cast<VkDebugUtilsMessageSeverityFlagsEXT>(VK_DEBUG_UTILS_MESSAGE_SEVERITY_WARNING_BIT_EXT) |
-                                  static_cast<VkDebugUtilsMessageSeverityFlagsEXT>(VK_DEBUG_UTILS_MESSAGE_SEVERITY_ERROR_BIT_EXT);
+    // Only the severities that are printed, so the layer doesn't even build the messages that would be filtered anyway.
+    createInfo->messageSeverity = validation::MessageLog::SeverityMask(m_settings.validationSeverity);
 
     createInfo->messageType = static_cast<VkDebugUtilsMessageTypeFlagsEXT>(VK_DEBUG_UTILS_MESSAGE_TYPE_GENERAL_BIT_EXT) |
                               static_cast<VkDebugUtilsMessageTypeFlagsEXT>(VK_DEBUG_UTILS_MESSAGE_TYPE_VALIDATION_BIT_EXT) |
                               static_cast<VkDebugUtilsMessageTypeFlagsEXT>(VK_DEBUG_UTILS_MESSAGE_TYPE_PERFORMANCE_BIT_EXT);
 
     createInfo->pfnUserCallback = validation::DebugCallback;
-    createInfo->pUserData       = this;  // Optional - nullptr
+    createInfo->pUserData       = log;
 
     return createInfo;
 }
 
 void HelloTriangleApplication::CreateSurface() {
+    VT_TRACE_ZONE("CreateSurface");
+
     if (const auto& result = glfwCreateWindowSurface(m_instance, m_window, nullptr, &m_surface) != VK_SUCCESS) {
         throw std::runtime_error(std::format("{}::CreateSurface: Failed to create window surface, error code: {}.", kClassName, result));
     }
 }
 
 void HelloTriangleApplication::PickPhysicalDevice() {
+    VT_TRACE_ZONE("PickPhysicalDevice");
+
     uint32_t deviceCount = 0;
     vkEnumeratePhysicalDevices(m_instance, &deviceCount, nullptr);
 
@@ -269,36 +798,112 @@ void HelloTriangleApplication::PickPhysicalDevice() {
 }
 
 void HelloTriangleApplication::CreateLogicalDevice() {
+    VT_TRACE_ZONE("CreateLogicalDevice");
+
+    // Every renderer on a shared device gets queues of its own, a VkQueue can't be used from two threads without locking around it.
+    const auto shared = m_context->AcquireSharedDevice([this]() { return CreateDevice(m_context->GetRendererCount()); });
+
+    VulkanContext::Device device = {};
+    if (shared.has_value()) {
+        device       = shared->first;
+        m_queueIndex = shared->second;
+    } else {
+        if (m_context->SharesDevice()) {
+            std::cout << std::format("{}::CreateLogicalDevice: No queues left on the shared device, creating a device of its own.\n", kClassName);
+        }
+
+        device       = CreateDevice(1);
+        m_queueIndex = 0;
+        m_ownsDevice = true;
+    }
+
+    m_physicalDevice   = device.physicalDevice;
+    m_device           = device.device;
+    m_dynamicRendering = device.dynamicRendering;
+    m_depthFormat      = UsesDepthBuffer() ? ChooseDepthFormat() : VK_FORMAT_UNDEFINED;
+
+    // Retrieve the queue handles for each QueueFamily.
+    QueueFamilyIndices indices = FindQueueFamilies(m_physicalDevice);
+    vkGetDeviceQueue(m_device, indices.GetGraphicsFamilyValue(), m_queueIndex, &m_graphicsQueue);
+    vkGetDeviceQueue(m_device, indices.GetPresentFamilyValue(), m_queueIndex, &m_presentQueue);
+    vkGetDeviceQueue(m_device, indices.GetTransferFamilyValue(), m_queueIndex, &m_transferQueue);  // The graphics queue itself without a transfer family.
+}
+
+auto HelloTriangleApplication::CreateDevice(uint32_t queueCount) -> VulkanContext::Device {
+    VulkanContext::Device device = { .physicalDevice = m_physicalDevice, .device = VK_NULL_HANDLE, .queueCount = queueCount, .dynamicRendering = false };
+
     QueueFamilyIndices indices = FindQueueFamilies(m_physicalDevice);
 
-    std::vector<VkDeviceQueueCreateInfo> queueCreateInfos    = {};
-    const std::set<uint32_t>             uniqueQueueFamilies = { indices.GetGraphicsFamilyValue(), indices.GetPresentFamilyValue() };
+    uint32_t familyCount = { 0 };
+    vkGetPhysicalDeviceQueueFamilyProperties(m_physicalDevice, &familyCount, nullptr);
+    std::vector<VkQueueFamilyProperties> familyProperties(familyCount);
+    vkGetPhysicalDeviceQueueFamilyProperties(m_physicalDevice, &familyCount, familyProperties.data());
+
+    // As many queues as asked for, limited by the smallest of the families used.
+    const std::set<uint32_t> uniqueQueueFamilies = { indices.GetGraphicsFamilyValue(), indices.GetPresentFamilyValue(), indices.GetTransferFamilyValue() };
+    for (const uint32_t queueFamily : uniqueQueueFamilies) {
+        device.queueCount = std::min(device.queueCount, familyProperties[queueFamily].queueCount);
+    }
 
-    const float queuePriority = 1.0F;
+    std::vector<VkDeviceQueueCreateInfo> queueCreateInfos = {};
+    const std::vector<float>             queuePriorities(device.queueCount, 1.0F);
     for (const uint32_t queueFamily : uniqueQueueFamilies) {
         // clang-format off
         const VkDeviceQueueCreateInfo queueCreateInfo = { .sType            = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO,
                                                     .pNext            = nullptr,
                                                     .flags            = {},
                                                     .queueFamilyIndex = queueFamily,
-                                                    .queueCount       = 1,
-                                                    .pQueuePriorities = &queuePriority };
+                                                    .queueCount       = device.queueCount,
+                                                    .pQueuePriorities = queuePriorities.data() };
         // clang-format on
         queueCreateInfos.push_back(queueCreateInfo);
     }
 
-    const VkPhysicalDeviceFeatures deviceFeatures = {};
+    // Dynamic rendering is core in Vulkan 1.3, but it is still only used when the device reports the feature.
+    VkPhysicalDeviceVulkan13Features supported13 = {};
+    supported13.sType                            = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_3_FEATURES;
+
+    VkPhysicalDeviceFeatures2 supportedFeatures = {};
+    supportedFeatures.sType                     = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+    supportedFeatures.pNext                     = &supported13;
+    vkGetPhysicalDeviceFeatures2(m_physicalDevice, &supportedFeatures);
+
+    device.dynamicRendering = m_settings.dynamicRendering && VK_TRUE == supported13.dynamicRendering;
+    std::cout << std::format("{}::CreateDevice: Rendering with {}, {} queue(s) per family.\n", kClassName,
+                             device.dynamicRendering ? "vkCmdBeginRendering" : "a render pass and framebuffers", device.queueCount);
+
+    // Features are enabled through the VkPhysicalDeviceFeatures2 chain, hence pEnabledFeatures stays nullptr.
+    VkPhysicalDeviceVulkan13Features features13 = {};
+    features13.sType                            = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_3_FEATURES;
+    features13.synchronization2                 = VK_TRUE;
+    features13.dynamicRendering                 = device.dynamicRendering ? VK_TRUE : VK_FALSE;
+
+    VkPhysicalDeviceVulkan12Features features12 = {};
+    features12.sType                            = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+    features12.pNext                            = &features13;
+    features12.timelineSemaphore                = VK_TRUE;
+    features12.drawIndirectCount                = CullingMode::GPU == m_settings.culling ? VK_TRUE : VK_FALSE;
+
+    VkPhysicalDeviceFeatures2 deviceFeatures = {};
+    deviceFeatures.sType                     = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+    deviceFeatures.pNext                     = &features12;
+
+    // The overdraw counter's query stays active while the recording threads' secondary command buffers execute, hence inherited queries.
+    deviceFeatures.features.pipelineStatisticsQuery = m_settings.overdrawStats ? VK_TRUE : VK_FALSE;
+    deviceFeatures.features.inheritedQueries        = m_settings.overdrawStats && 0 != m_settings.recordThreads ? VK_TRUE : VK_FALSE;
+
+    const auto deviceExtensions = GetRequiredDeviceExtensions();
 
     VkDeviceCreateInfo createInfo = { .sType                   = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO,
-                                      .pNext                   = nullptr,
+                                      .pNext                   = &deviceFeatures,
                                       .flags                   = {},
                                       .queueCreateInfoCount    = static_cast<uint32_t>(queueCreateInfos.size()),
                                       .pQueueCreateInfos       = queueCreateInfos.data(),
                                       .enabledLayerCount       = 0,        // Deprecated.
                                       .ppEnabledLayerNames     = nullptr,  // Deprecated.
-                                      .enabledExtensionCount   = static_cast<uint32_t>(m_deviceExtensions.size()),
-                                      .ppEnabledExtensionNames = m_deviceExtensions.data(),
-                                      .pEnabledFeatures        = &deviceFeatures };
+                                      .enabledExtensionCount   = static_cast<uint32_t>(deviceExtensions.size()),
+                                      .ppEnabledExtensionNames = deviceExtensions.data(),
+                                      .pEnabledFeatures        = nullptr };
 
     if (kEnableValidationLayers) {
         // Deprecated, but can be good to set anyways to be compatible with older implementations.
@@ -306,25 +911,27 @@ void HelloTriangleApplication::CreateLogicalDevice() {
         createInfo.ppEnabledLayerNames = m_validationLayers.data();
     }
 
-    if (const auto& result = vkCreateDevice(m_physicalDevice, &createInfo, nullptr, &m_device) != VK_SUCCESS) {
-        throw std::runtime_error(std::format("{}::CreateLogicalDevice: Failed to logical device, error code: {}.", kClassName, result));
+    if (const auto& result = vkCreateDevice(m_physicalDevice, &createInfo, nullptr, &device.device) != VK_SUCCESS) {
+        throw std::runtime_error(std::format("{}::CreateDevice: Failed to logical device, error code: {}.", kClassName, result));
     }
 
-    // Retrieve the queue handles for each QueueFamily.
-    vkGetDeviceQueue(m_device, indices.GetGraphicsFamilyValue(), 0, &m_graphicsQueue);
-    vkGetDeviceQueue(m_device, indices.GetPresentFamilyValue(), 0, &m_presentQueue);
+    return device;
 }
 
 auto HelloTriangleApplication::RateDeviceSuitability(VkPhysicalDevice device) -> uint32_t {
     uint32_t score = 0;
 
-    const QueueFamilyIndices      indices             = FindQueueFamilies(device);
-    const bool                    extensionSupported  = CheckDeviceExtensionSupport(device);
-    const SwapChainSupportDetails swapChainSupport    = QuerySwapChainSupport(device);
-    const bool                    isSwapChainAdequate = !swapChainSupport.formats.empty() && !swapChainSupport.presentModes.empty();
+    const QueueFamilyIndices indices             = FindQueueFamilies(device);
+    const bool               extensionSupported  = CheckDeviceExtensionSupport(device);
+    bool                     isSwapChainAdequate = true;
+
+    if (!m_settings.headless) {
+        const SwapChainSupportDetails swapChainSupport = QuerySwapChainSupport(device);
+        isSwapChainAdequate                            = !swapChainSupport.formats.empty() && !swapChainSupport.presentModes.empty();
+    }
 
     // Device is not supported, return a score of 0.
-    if (!indices.IsComplete() || !extensionSupported || !isSwapChainAdequate) {
+    if (!indices.IsComplete() || !extensionSupported || !isSwapChainAdequate || !CheckDeviceFeatureSupport(device)) {
         return 0;
     }
 
@@ -367,7 +974,9 @@ auto HelloTriangleApplication::FindQueueFamilies(VkPhysicalDevice device) -> Hel
     uint32_t idx = 0;
     for (const auto& qFamily : queueFamilies) {
         auto presentSupport = static_cast<VkBool32>(false);
-        vkGetPhysicalDeviceSurfaceSupportKHR(device, idx, m_surface, &presentSupport);
+        if (!m_settings.headless) {
+            vkGetPhysicalDeviceSurfaceSupportKHR(device, idx, m_surface, &presentSupport);
+        }
 
         if (static_cast<bool>(presentSupport)) {
             indices.presentFamily = idx;
@@ -375,16 +984,46 @@ auto HelloTriangleApplication::FindQueueFamilies(VkPhysicalDevice device) -> Hel
 
         if (0 != (qFamily.queueFlags & VK_QUEUE_GRAPHICS_BIT)) {
             indices.graphicsFamily = idx;
+
+            // Nothing is presented in headless mode, let the graphics queue stand in for the present queue.
+            if (m_settings.headless) {
+                indices.presentFamily = idx;
+            }
         }
 
-        // Return if a queue family is found.
+        // Stop if a queue family is found.
         if (indices.IsComplete()) {
-            return indices;
+            break;
         }
 
         idx++;
     }
 
+    // Prefer a transfer only family, usually the DMA engines of a discrete GPU, then any family without graphics.
+    // Without either, uploads share the graphics queue.
+    if (m_settings.transferQueue) {
+        std::optional<uint32_t> asyncFamily = std::nullopt;
+        for (uint32_t i = 0; i < queueFamilyCount; i++) {
+            const VkQueueFlags flags = queueFamilies[i].queueFlags;
+            if (0 == (flags & VK_QUEUE_TRANSFER_BIT) || 0 != (flags & VK_QUEUE_GRAPHICS_BIT)) {
+                continue;
+            }
+
+            if (0 == (flags & VK_QUEUE_COMPUTE_BIT)) {
+                indices.transferFamily = i;
+                break;
+            }
+
+            if (!asyncFamily.has_value()) {
+                asyncFamily = i;
+            }
+        }
+
+        if (!indices.transferFamily.has_value()) {
+            indices.transferFamily = asyncFamily;
+        }
+    }
+
     return indices;
 }
 
@@ -416,22 +1055,13 @@ auto HelloTriangleApplication::QuerySwapChainSupport(VkPhysicalDevice device) ->
 }
 
 void HelloTriangleApplication::CreateSwapchain() {
+    VT_TRACE_ZONE("CreateSwapchain");
+
     const SwapChainSupportDetails swapChainSupport = QuerySwapChainSupport(m_physicalDevice);
     const VkSurfaceFormatKHR      surfaceFormat    = utilities::ChooseSwapSurfaceFormat(swapChainSupport.formats);
-    const VkPresentModeKHR        presentMode      = utilities::ChooseSwapPresentMode(swapChainSupport.presentModes);
+    const VkPresentModeKHR        presentMode      = utilities::ChooseSwapPresentMode(swapChainSupport.presentModes, PresentModePreferences(m_settings.presentPolicy));
     const VkExtent2D              extent           = ChooseSwapExtent(swapChainSupport.capabilities);
-
-    // Decide how many images we would like to have in the swap chain.
-    // The implementation specifies the minimum number that it requires to function.
-    // However, simply sticking to this minimum means that we may sometimes have to wait on the driver
-    // to complete internal operations before we can acquire another image to render to.
-    // Therefore it is recommended to request at least one more image than the minimum.
-    uint32_t imageCount = swapChainSupport.capabilities.minImageCount + 1;
-
-    // Where 'maxImageCount' == 0 is a special value that means that there is no maximum.
-    if (swapChainSupport.capabilities.maxImageCount > 0 && imageCount > swapChainSupport.capabilities.maxImageCount) {
-        imageCount = swapChainSupport.capabilities.maxImageCount;
-    }
+    uint32_t                      imageCount       = ChooseSwapImageCount(swapChainSupport.capabilities);
 
     QueueFamilyIndices       indices            = FindQueueFamilies(m_physicalDevice);
     std::array<uint32_t, 2>  queueFamilyIndices = { indices.GetGraphicsFamilyValue(), indices.GetPresentFamilyValue() };
@@ -452,7 +1082,15 @@ void HelloTriangleApplication::CreateSwapchain() {
                                                     .compositeAlpha        = VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR,
                                                     .presentMode           = presentMode,
                                                     .clipped               = VK_TRUE,
-                                                    .oldSwapchain          = VK_NULL_HANDLE };
+                                                    .oldSwapchain          = m_swapChain };  // Lets the driver reuse resources on recreation.
+
+    // Frame capture copies out of the swap chain images.
+    if (!m_settings.capturePath.empty()) {
+        if (0 == (swapChainSupport.capabilities.supportedUsageFlags & VK_IMAGE_USAGE_TRANSFER_SRC_BIT)) {
+            throw std::runtime_error(std::format("{}::CreateSwapchain: Frame capture needs swap chain images that can be copied from.", kClassName));
+        }
+        createInfo.imageUsage |= VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+    }
 
     // Update to exclusive mode if the image can be owned by one queue family.
     if (indices.graphicsFamily == indices.presentFamily) {
@@ -471,63 +1109,316 @@ void HelloTriangleApplication::CreateSwapchain() {
 
     m_swapChainImageFormat = surfaceFormat.format;
     m_swapChainExtent      = extent;
+    m_presentMode          = presentMode;
 }
 
-void HelloTriangleApplication::CreateImageViews() {
-    m_swapChainImageViews.resize(m_swapChainImages.size());
-    for (size_t i = 0; i < m_swapChainImages.size(); i++) {
-        const VkImageViewCreateInfo createInfo { .sType            = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO,
-                                                 .pNext            = nullptr,
-                                                 .flags            = {},
-                                                 .image            = m_swapChainImages[i],
-                                                 .viewType         = VK_IMAGE_VIEW_TYPE_2D,
-                                                 .format           = m_swapChainImageFormat,
-                                                 .components       = { .r = VK_COMPONENT_SWIZZLE_IDENTITY,
-                                                                       .g = VK_COMPONENT_SWIZZLE_IDENTITY,
-                                                                       .b = VK_COMPONENT_SWIZZLE_IDENTITY,
-                                                                       .a = VK_COMPONENT_SWIZZLE_IDENTITY },
-                                                 .subresourceRange = {
-                                                     .aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT,
-                                                     .baseMipLevel   = 0,
-                                                     .levelCount     = 1,
-                                                     .baseArrayLayer = 0,
-                                                     .layerCount     = 1,
-                                                 } };
-
-        if (const auto& result = vkCreateImageView(m_device, &createInfo, nullptr, &m_swapChainImageViews[i]) != VK_SUCCESS) {
-            throw std::runtime_error(std::format("{}::CreateImageViews: Failed to create image views, error code: {}.", kClassName, result));
-        }
+auto HelloTriangleApplication::PresentModePreferences(PresentPolicy policy) -> std::span<const VkPresentModeKHR> {
+    // FIFO is always available, so it ends up as the fallback of every policy.
+    static constexpr std::array kLowLatency  = { VK_PRESENT_MODE_MAILBOX_KHR, VK_PRESENT_MODE_IMMEDIATE_KHR, VK_PRESENT_MODE_FIFO_KHR };
+    static constexpr std::array kThroughput  = { VK_PRESENT_MODE_MAILBOX_KHR, VK_PRESENT_MODE_FIFO_KHR };
+    static constexpr std::array kPowerSaver  = { VK_PRESENT_MODE_FIFO_KHR };
+    static constexpr std::array kTearAllowed = { VK_PRESENT_MODE_IMMEDIATE_KHR, VK_PRESENT_MODE_FIFO_RELAXED_KHR, VK_PRESENT_MODE_FIFO_KHR };
+
+    switch (policy) {
+        case PresentPolicy::THROUGHPUT:   return kThroughput;
+        case PresentPolicy::POWER_SAVER:  return kPowerSaver;
+        case PresentPolicy::TEAR_ALLOWED: return kTearAllowed;
+        default:                          return kLowLatency;
     }
 }
 
-auto HelloTriangleApplication::ChooseSwapExtent(const VkSurfaceCapabilitiesKHR& capabilities) -> VkExtent2D {
-    if (capabilities.currentExtent.width != std::numeric_limits<uint32_t>::max()) {
-        return capabilities.currentExtent;
+auto HelloTriangleApplication::ChooseSwapImageCount(const VkSurfaceCapabilitiesKHR& capabilities) const -> uint32_t {
+    // The implementation specifies the minimum number of images that it requires to function. Sticking to this minimum means
+    // that we may sometimes have to wait on the driver to complete internal operations before we can acquire another image,
+    // which caps the frame rate but also how many frames can queue up in front of the display. Every extra image is one more
+    // frame the GPU can work ahead, trading latency (and memory) for throughput.
+    uint32_t imageCount = capabilities.minImageCount;
+    switch (m_settings.presentPolicy) {
+        case PresentPolicy::THROUGHPUT:  imageCount += 2; break;
+        case PresentPolicy::POWER_SAVER: break;
+        default:                         imageCount += 1; break;
+    }
+
+    // Where 'maxImageCount' == 0 is a special value that means that there is no maximum.
+    if (capabilities.maxImageCount > 0 && imageCount > capabilities.maxImageCount) {
+        imageCount = capabilities.maxImageCount;
     }
 
+    return imageCount;
+}
+
+void HelloTriangleApplication::RecreateSwapchain() {
+    VT_TRACE_ZONE("RecreateSwapchain");
+
+    // A minimized window has a zero sized framebuffer, which is not a valid swap chain extent, so wait until it is visible again.
     int32_t width  = { 0 };
     int32_t height = { 0 };
     glfwGetFramebufferSize(m_window, &width, &height);
+    while (0 == width || 0 == height) {
+        glfwWaitEvents();
+        glfwGetFramebufferSize(m_window, &width, &height);
+    }
 
-    VkExtent2D actualExtent = { static_cast<uint32_t>(width), static_cast<uint32_t>(height) };
-    actualExtent.width      = std::clamp(actualExtent.width, capabilities.minImageExtent.width, capabilities.maxImageExtent.width);
-    actualExtent.height     = std::clamp(actualExtent.height, capabilities.minImageExtent.height, capabilities.maxImageExtent.height);
+    m_framebufferResized = false;
 
-    return actualExtent;
-}
+    // Instead of vkDeviceWaitIdle, hand the old objects over to the retire queue and keep rendering.
+    // The old swap chain stays valid as 'oldSwapchain' until the new one has been created.
+    m_retiredSwapchains.push_back({ .retiredAtFrame           = m_frameNumber,
+                                    .swapChain                = m_swapChain,
+                                    .imageViews               = std::exchange(m_swapChainImageViews, {}),
+                                    .framebuffers             = std::exchange(m_swapChainFramebuffers, {}),
+                                    .renderFinishedSemaphores = std::exchange(m_renderFinishedSemaphores, {}),
+                                    .staticCommandBuffers     = std::exchange(m_staticCommandBuffers, {}),
+                                    .depthImage               = std::exchange(m_depthImage, {}),
+                                    .depthImageView           = std::exchange(m_depthImageView, VK_NULL_HANDLE) });
 
-void HelloTriangleApplication::CreateRenderPass() {
-    const VkAttachmentDescription colorAttachment { .flags          = {},
-                                                    .format         = m_swapChainImageFormat,
-                                                    .samples        = VK_SAMPLE_COUNT_1_BIT,
-                                                    .loadOp         = VK_ATTACHMENT_LOAD_OP_CLEAR,
-                                                    .storeOp        = VK_ATTACHMENT_STORE_OP_STORE,
-                                                    .stencilLoadOp  = VK_ATTACHMENT_LOAD_OP_DONT_CARE,
-                                                    .stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE,
-                                                    .initialLayout  = VK_IMAGE_LAYOUT_UNDEFINED,
-                                                    .finalLayout    = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR };
+    const VkFormat previousFormat = m_swapChainImageFormat;
+
+    CreateSwapchain();
+    CreateImageViews();
+    CreateDepthResources();
+
+    // The readback buffers match the image size, the capture waits for the frames it still has to write before it replaces them.
+    if (nullptr != m_frameCapture && (m_frameCapture->GetExtent().width != m_swapChainExtent.width ||
+                                      m_frameCapture->GetExtent().height != m_swapChainExtent.height || previousFormat != m_swapChainImageFormat)) {
+        m_frameCapture->Resize(m_swapChainExtent, m_swapChainImageFormat);
+    }
+
+    // The surface format practically never changes, but if it does the render pass and pipeline are no longer compatible.
+    if (previousFormat != m_swapChainImageFormat) {
+        WaitIdle();
+        m_pipelineVariants.reset();
+        vkDestroyPipeline(m_device, m_graphicsPipeline, nullptr);
+        vkDestroyPipelineLayout(m_device, m_pipelineLayout, nullptr);
+        if (!m_dynamicRendering) {
+            vkDestroyRenderPass(m_device, m_renderPass, nullptr);
+            CreateRenderPass();
+        }
+        CreateGraphicsPipeline();
+    }
+
+    // With dynamic rendering the image views are all there is to rebuild.
+    if (!m_dynamicRendering) {
+        CreateFramebuffers();
+    }
+    CreateRenderFinishedSemaphores();
+
+    if (m_settings.staticScene) {
+        RecordStaticCommandBuffers();
+    }
+}
+
+void HelloTriangleApplication::ReleaseRetiredSwapchains(bool force) {
+    // The frames submitted before 'retiredAtFrame' have all finished once the frame timeline has reached that value.
+    //
+    // Note: Without VK_EXT_swapchain_maintenance1 there is no way to know when the presentation engine is done with
+    // the render finished semaphores, but by then it has consumed them for every practical implementation.
+    if (m_retiredSwapchains.empty()) {
+        return;
+    }
+
+    const uint64_t completedFrames = force ? UINT64_MAX : GetCompletedFrameCount();
+    while (!m_retiredSwapchains.empty() && completedFrames >= m_retiredSwapchains.front().retiredAtFrame) {
+        RetiredSwapchain& retired = m_retiredSwapchains.front();
+
+        for (auto* framebuffer : retired.framebuffers) {
+            vkDestroyFramebuffer(m_device, framebuffer, nullptr);
+        }
+
+        for (auto* imageView : retired.imageViews) {
+            vkDestroyImageView(m_device, imageView, nullptr);
+        }
+
+        for (auto* semaphore : retired.renderFinishedSemaphores) {
+            vkDestroySemaphore(m_device, semaphore, nullptr);
+        }
+
+        if (VK_NULL_HANDLE != retired.depthImage.image) {
+            vkDestroyImageView(m_device, retired.depthImageView, nullptr);
+            m_allocator->DestroyImage(retired.depthImage);
+        }
+
+        if (!retired.staticCommandBuffers.empty()) {
+            vkFreeCommandBuffers(m_device, m_commandPool, static_cast<uint32_t>(retired.staticCommandBuffers.size()), retired.staticCommandBuffers.data());
+        }
+
+        vkDestroySwapchainKHR(m_device, retired.swapChain, nullptr);
+        m_retiredSwapchains.pop_front();
+    }
+}
+
+void HelloTriangleApplication::CreateOffscreenTargets() {
+    VT_TRACE_ZONE("CreateOffscreenTargets");
+
+    // One target per frame slot, mirroring what a swap chain would hand out. The images are left in
+    // TRANSFER_SRC_OPTIMAL after rendering so that they can be copied out, see FinalImageLayout.
+    m_swapChainImageFormat = VK_FORMAT_B8G8R8A8_SRGB;
+    m_swapChainExtent      = { .width = kWidth, .height = kHeight };
+    m_swapChainImages.resize(m_settings.framesInFlight);
+    m_offscreenImageAllocations.resize(m_settings.framesInFlight);
+
+    for (size_t i = 0; i < m_swapChainImages.size(); i++) {
+        const VkImageCreateInfo imageInfo = { .sType                 = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO,
+                                              .pNext                 = nullptr,
+                                              .flags                 = {},
+                                              .imageType             = VK_IMAGE_TYPE_2D,
+                                              .format                = m_swapChainImageFormat,
+                                              .extent                = { .width = m_swapChainExtent.width, .height = m_swapChainExtent.height, .depth = 1 },
+                                              .mipLevels             = 1,
+                                              .arrayLayers           = 1,
+                                              .samples               = VK_SAMPLE_COUNT_1_BIT,
+                                              .tiling                = VK_IMAGE_TILING_OPTIMAL,
+                                              .usage                 = static_cast<VkImageUsageFlags>(VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT) |
+                                                                       static_cast<VkImageUsageFlags>(VK_IMAGE_USAGE_TRANSFER_SRC_BIT),
+                                              .sharingMode           = VK_SHARING_MODE_EXCLUSIVE,
+                                              .queueFamilyIndexCount = 0,
+                                              .pQueueFamilyIndices   = nullptr,
+                                              .initialLayout         = VK_IMAGE_LAYOUT_UNDEFINED };
+
+        const auto image = m_allocator->CreateImage(imageInfo, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+        m_swapChainImages[i]           = image.image;
+        m_offscreenImageAllocations[i] = image.allocation;
+    }
+}
+
+void HelloTriangleApplication::CreateImageViews() {
+    VT_TRACE_ZONE("CreateImageViews");
+
+    m_swapChainImageViews.resize(m_swapChainImages.size());
+    for (size_t i = 0; i < m_swapChainImages.size(); i++) {
+        const VkImageViewCreateInfo createInfo { .sType            = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO,
+                                                 .pNext            = nullptr,
+                                                 .flags            = {},
+                                                 .image            = m_swapChainImages[i],
+                                                 .viewType         = VK_IMAGE_VIEW_TYPE_2D,
+                                                 .format           = m_swapChainImageFormat,
+                                                 .components       = { .r = VK_COMPONENT_SWIZZLE_IDENTITY,
+                                                                       .g = VK_COMPONENT_SWIZZLE_IDENTITY,
+                                                                       .b = VK_COMPONENT_SWIZZLE_IDENTITY,
+                                                                       .a = VK_COMPONENT_SWIZZLE_IDENTITY },
+                                                 .subresourceRange = {
+                                                     .aspectMask     = VK_IMAGE_ASPECT_COLOR_BIT,
+                                                     .baseMipLevel   = 0,
+                                                     .levelCount     = 1,
+                                                     .baseArrayLayer = 0,
+                                                     .layerCount     = 1,
+                                                 } };
+
+        if (const auto& result = vkCreateImageView(m_device, &createInfo, nullptr, &m_swapChainImageViews[i]) != VK_SUCCESS) {
+            throw std::runtime_error(std::format("{}::CreateImageViews: Failed to create image views, error code: {}.", kClassName, result));
+        }
+    }
+}
+
+void HelloTriangleApplication::CreateDepthResources() {
+    VT_TRACE_ZONE("CreateDepthResources");
+
+    if (VK_FORMAT_UNDEFINED == m_depthFormat) {
+        return;
+    }
+
+    // Cleared at the start of every frame and never read afterwards, so the contents are never stored, see CreateRenderPass.
+    const VkImageCreateInfo imageInfo = { .sType                 = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO,
+                                          .pNext                 = nullptr,
+                                          .flags                 = {},
+                                          .imageType             = VK_IMAGE_TYPE_2D,
+                                          .format                = m_depthFormat,
+                                          .extent                = { .width = m_swapChainExtent.width, .height = m_swapChainExtent.height, .depth = 1 },
+                                          .mipLevels             = 1,
+                                          .arrayLayers           = 1,
+                                          .samples               = VK_SAMPLE_COUNT_1_BIT,
+                                          .tiling                = VK_IMAGE_TILING_OPTIMAL,
+                                          .usage                 = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT,
+                                          .sharingMode           = VK_SHARING_MODE_EXCLUSIVE,
+                                          .queueFamilyIndexCount = 0,
+                                          .pQueueFamilyIndices   = nullptr,
+                                          .initialLayout         = VK_IMAGE_LAYOUT_UNDEFINED };
+
+    m_depthImage = m_allocator->CreateImage(imageInfo, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+
+    const VkImageViewCreateInfo viewInfo { .sType            = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO,
+                                           .pNext            = nullptr,
+                                           .flags            = {},
+                                           .image            = m_depthImage.image,
+                                           .viewType         = VK_IMAGE_VIEW_TYPE_2D,
+                                           .format           = m_depthFormat,
+                                           .components       = { .r = VK_COMPONENT_SWIZZLE_IDENTITY,
+                                                                 .g = VK_COMPONENT_SWIZZLE_IDENTITY,
+                                                                 .b = VK_COMPONENT_SWIZZLE_IDENTITY,
+                                                                 .a = VK_COMPONENT_SWIZZLE_IDENTITY },
+                                           .subresourceRange = {
+                                               .aspectMask     = VK_IMAGE_ASPECT_DEPTH_BIT,
+                                               .baseMipLevel   = 0,
+                                               .levelCount     = 1,
+                                               .baseArrayLayer = 0,
+                                               .layerCount     = 1,
+                                           } };
+
+    if (const auto& result = vkCreateImageView(m_device, &viewInfo, nullptr, &m_depthImageView) != VK_SUCCESS) {
+        throw std::runtime_error(std::format("{}::CreateDepthResources: Failed to create depth image view, error code: {}.", kClassName, result));
+    }
+}
+
+auto HelloTriangleApplication::ChooseDepthFormat() const -> VkFormat {
+    // Depth only formats, the instances have no use for a stencil. Every implementation supports D16_UNORM, the others are preferred for their precision.
+    static constexpr std::array kCandidates = { VK_FORMAT_D32_SFLOAT, VK_FORMAT_X8_D24_UNORM_PACK32, VK_FORMAT_D16_UNORM };
+
+    for (const VkFormat format : kCandidates) {
+        VkFormatProperties properties = {};
+        vkGetPhysicalDeviceFormatProperties(m_physicalDevice, format, &properties);
+
+        if (0 != (properties.optimalTilingFeatures & VK_FORMAT_FEATURE_DEPTH_STENCIL_ATTACHMENT_BIT)) {
+            return format;
+        }
+    }
+
+    throw std::runtime_error(std::format("{}::ChooseDepthFormat: No supported depth attachment format.", kClassName));
+}
+
+auto HelloTriangleApplication::ChooseSwapExtent(const VkSurfaceCapabilitiesKHR& capabilities) -> VkExtent2D {
+    if (capabilities.currentExtent.width != std::numeric_limits<uint32_t>::max()) {
+        return capabilities.currentExtent;
+    }
+
+    int32_t width  = { 0 };
+    int32_t height = { 0 };
+    glfwGetFramebufferSize(m_window, &width, &height);
+
+    VkExtent2D actualExtent = { static_cast<uint32_t>(width), static_cast<uint32_t>(height) };
+    actualExtent.width      = std::clamp(actualExtent.width, capabilities.minImageExtent.width, capabilities.maxImageExtent.width);
+    actualExtent.height     = std::clamp(actualExtent.height, capabilities.minImageExtent.height, capabilities.maxImageExtent.height);
+
+    return actualExtent;
+}
+
+void HelloTriangleApplication::CreateRenderPass() {
+    VT_TRACE_ZONE("CreateRenderPass");
+
+    const VkAttachmentDescription colorAttachment { .flags          = {},
+                                                    .format         = m_swapChainImageFormat,
+                                                    .samples        = VK_SAMPLE_COUNT_1_BIT,
+                                                    .loadOp         = VK_ATTACHMENT_LOAD_OP_CLEAR,
+                                                    .storeOp        = VK_ATTACHMENT_STORE_OP_STORE,
+                                                    .stencilLoadOp  = VK_ATTACHMENT_LOAD_OP_DONT_CARE,
+                                                    .stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE,
+                                                    .initialLayout  = VK_IMAGE_LAYOUT_UNDEFINED,
+                                                    .finalLayout    = FinalImageLayout() };
+
+    // Only the depth test reads the depth buffer, it starts cleared and its contents are dropped at the end of the pass.
+    const VkAttachmentDescription depthAttachment { .flags          = {},
+                                                    .format         = m_depthFormat,
+                                                    .samples        = VK_SAMPLE_COUNT_1_BIT,
+                                                    .loadOp         = VK_ATTACHMENT_LOAD_OP_CLEAR,
+                                                    .storeOp        = VK_ATTACHMENT_STORE_OP_DONT_CARE,
+                                                    .stencilLoadOp  = VK_ATTACHMENT_LOAD_OP_DONT_CARE,
+                                                    .stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE,
+                                                    .initialLayout  = VK_IMAGE_LAYOUT_UNDEFINED,
+                                                    .finalLayout    = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL };
+
+    const std::array<VkAttachmentDescription, 2> attachments = { colorAttachment, depthAttachment };
 
     const VkAttachmentReference colorAttachmentRef = { .attachment = 0, .layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL };
+    const VkAttachmentReference depthAttachmentRef = { .attachment = 1, .layout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL };
 
     const VkSubpassDescription subpass = { .flags                   = {},
                                            .pipelineBindPoint       = VK_PIPELINE_BIND_POINT_GRAPHICS,
@@ -536,23 +1427,27 @@ void HelloTriangleApplication::CreateRenderPass() {
                                            .colorAttachmentCount    = 1,
                                            .pColorAttachments       = &colorAttachmentRef,
                                            .pResolveAttachments     = nullptr,
-                                           .pDepthStencilAttachment = nullptr,
+                                           .pDepthStencilAttachment = UsesDepthBuffer() ? &depthAttachmentRef : nullptr,
                                            .preserveAttachmentCount = 0,
                                            .pPreserveAttachments    = nullptr };
 
+    // The depth buffer is shared by every frame, so its clear also waits for the depth writes of the previous frame.
     const VkSubpassDependency dependency = { .srcSubpass      = VK_SUBPASS_EXTERNAL,
                                              .dstSubpass      = 0,
-                                             .srcStageMask    = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
-                                             .dstStageMask    = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
-                                             .srcAccessMask   = 0,
-                                             .dstAccessMask   = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,
+                                             .srcStageMask    = static_cast<VkPipelineStageFlags>(VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT) |
+                                                                static_cast<VkPipelineStageFlags>(VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT),
+                                             .dstStageMask    = static_cast<VkPipelineStageFlags>(VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT) |
+                                                                static_cast<VkPipelineStageFlags>(VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT),
+                                             .srcAccessMask   = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
+                                             .dstAccessMask   = static_cast<VkAccessFlags>(VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT) |
+                                                                static_cast<VkAccessFlags>(VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT),
                                              .dependencyFlags = {} };
 
     const VkRenderPassCreateInfo renderPassInfo = { .sType           = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO,
                                                     .pNext           = nullptr,
                                                     .flags           = {},
-                                                    .attachmentCount = 1,
-                                                    .pAttachments    = &colorAttachment,
+                                                    .attachmentCount = UsesDepthBuffer() ? 2U : 1U,
+                                                    .pAttachments    = attachments.data(),
                                                     .subpassCount    = 1,
                                                     .pSubpasses      = &subpass,
                                                     .dependencyCount = 1,
@@ -563,13 +1458,107 @@ void HelloTriangleApplication::CreateRenderPass() {
     }
 }
 
+void HelloTriangleApplication::CreatePipelineCache() {
+    VT_TRACE_ZONE("CreatePipelineCache");
+
+    VkPhysicalDeviceProperties properties = {};
+    vkGetPhysicalDeviceProperties(m_physicalDevice, &properties);
+
+    std::vector<char> initialData = {};
+    if (!m_settings.pipelineCachePath.empty()) {
+        initialData = pipeline_cache::Load(m_settings.pipelineCachePath, properties);
+    }
+
+    VkPipelineCacheCreateInfo createInfo = { .sType           = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO,
+                                             .pNext           = nullptr,
+                                             .flags           = {},
+                                             .initialDataSize = initialData.size(),
+                                             .pInitialData    = initialData.data() };
+
+    // The driver may still reject data that passed our own checks, fall back to an empty (cold) cache in that case.
+    if (vkCreatePipelineCache(m_device, &createInfo, nullptr, &m_pipelineCache) != VK_SUCCESS) {
+        createInfo.initialDataSize = 0;
+        createInfo.pInitialData    = nullptr;
+        initialData.clear();
+
+        if (const auto& result = vkCreatePipelineCache(m_device, &createInfo, nullptr, &m_pipelineCache) != VK_SUCCESS) {
+            throw std::runtime_error(std::format("{}::CreatePipelineCache: Failed to create pipeline cache, error code: {}.", kClassName, result));
+        }
+    }
+
+    m_pipelineStats.cacheWarm = !initialData.empty();
+}
+
+void HelloTriangleApplication::SavePipelineCache() {
+    if (m_settings.pipelineCachePath.empty() || VK_NULL_HANDLE == m_pipelineCache) {
+        return;
+    }
+
+    size_t dataSize = { 0 };
+    vkGetPipelineCacheData(m_device, m_pipelineCache, &dataSize, nullptr);
+
+    std::vector<char> data(dataSize);
+    if (vkGetPipelineCacheData(m_device, m_pipelineCache, &dataSize, data.data()) != VK_SUCCESS) {
+        std::cerr << std::format("{}::SavePipelineCache: Failed to get pipeline cache data.\n", kClassName);
+        return;
+    }
+
+    VkPhysicalDeviceProperties properties = {};
+    vkGetPhysicalDeviceProperties(m_physicalDevice, &properties);
+
+    // Runs during Cleanup, a failure to persist the cache only costs the next start its warm cache.
+    try {
+        pipeline_cache::Save(m_settings.pipelineCachePath, properties, { data.data(), dataSize });
+    } catch (const std::exception& e) {
+        std::cerr << std::format("{}::SavePipelineCache: {}\n", kClassName, e.what());
+    }
+}
+
 void HelloTriangleApplication::CreateGraphicsPipeline() {
-    const std::filesystem::path shaderPath     = std::filesystem::current_path() += std::filesystem::path("/build/vulkan-triangle/src");
-    const auto                  vertShaderCode = utilities::ReadBinaryFile(std::filesystem::path(shaderPath / "triangle.vert.spv").string());
-    const auto                  fragShaderCode = utilities::ReadBinaryFile(std::filesystem::path(shaderPath / "triangle.frag.spv").string());
+    VT_TRACE_ZONE("CreateGraphicsPipeline");
 
-    VkShaderModule vertShaderModule = CreateShaderModule(vertShaderCode);
-    VkShaderModule fragShaderModule = CreateShaderModule(fragShaderCode);
+    const VkPushConstantRange viewRange = { .stageFlags = VK_SHADER_STAGE_VERTEX_BIT, .offset = 0, .size = sizeof(geometry::View) };
+
+    // clang-format off
+    const VkPipelineLayoutCreateInfo pipelineLayoutInfo = {
+        .sType                  = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
+        .pNext                  = nullptr,
+        .flags                  = {},
+        .setLayoutCount         = 1,
+        .pSetLayouts            = &m_descriptorSetLayout,
+        .pushConstantRangeCount = 1,
+        .pPushConstantRanges    = &viewRange
+    };
+    // clang-format on
+
+    if (const auto& result = vkCreatePipelineLayout(m_device, &pipelineLayoutInfo, nullptr, &m_pipelineLayout) != VK_SUCCESS) {
+        throw std::runtime_error(std::format("{}::CreateGraphicsPipeline: Failed to create pipeline layout, error code: {}.", kClassName, result));
+    }
+
+    // Only the configured color mode is built up front, every other variant is compiled in the background the first time a frame asks for it.
+    const auto createStart     = std::chrono::steady_clock::now();
+    m_graphicsPipeline         = BuildGraphicsPipeline(m_settings.colorMode, m_swapChainImageFormat);
+    m_framePipeline            = m_graphicsPipeline;
+    m_pipelineStats.createTime = std::chrono::steady_clock::now() - createStart;
+
+    std::cout << std::format("{}::CreateGraphicsPipeline: Pipeline created in {:.3f} ms ({} pipeline cache).\n", kClassName,
+                             std::chrono::duration<double, std::milli>(m_pipelineStats.createTime).count(), m_pipelineStats.cacheWarm ? "warm" : "cold");
+
+    // The format is captured here, the compile thread must not read m_swapChainImageFormat while a swap chain recreation writes it.
+    m_pipelineVariants = std::make_unique<pipelines::PipelineVariants>(
+        m_device, kColorModeCount, [this, colorFormat = m_swapChainImageFormat](uint32_t variant) { return BuildGraphicsPipeline(static_cast<ColorMode>(variant), colorFormat); });
+}
+
+// Called from the pipeline compile thread as well, so it only reads state which stays constant for as long as m_pipelineVariants exists.
+auto HelloTriangleApplication::BuildGraphicsPipeline(ColorMode colorMode, VkFormat colorFormat) -> VkPipeline {
+    VT_TRACE_ZONE("BuildGraphicsPipeline");
+
+    const auto                     colorModeValue = static_cast<uint32_t>(colorMode);
+    const VkSpecializationMapEntry colorModeEntry = { .constantID = 0, .offset = 0, .size = sizeof(colorModeValue) };
+    const VkSpecializationInfo     specialization = { .mapEntryCount = 1, .pMapEntries = &colorModeEntry, .dataSize = sizeof(colorModeValue), .pData = &colorModeValue };
+
+    VkShaderModule vertShaderModule = CreateShaderModule("triangle.vert", shaders::kTriangleVert);
+    VkShaderModule fragShaderModule = CreateShaderModule("triangle.frag", shaders::kTriangleFrag);
 
     const VkPipelineShaderStageCreateInfo vertShaderStageInfo = {
         .sType               = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
@@ -577,8 +1566,8 @@ void HelloTriangleApplication::CreateGraphicsPipeline() {
         .flags               = {},
         .stage               = VK_SHADER_STAGE_VERTEX_BIT,
         .module              = vertShaderModule,
-        .pName               = "main",  // Entrypoint - can combine e.g. multiple modules.
-        .pSpecializationInfo = nullptr  // Optional   - specify values for shader constants.
+        .pName               = "main",          // Entrypoint - can combine e.g. multiple modules.
+        .pSpecializationInfo = &specialization  // Optional   - specify values for shader constants, here the color mode.
     };
 
     const VkPipelineShaderStageCreateInfo fragShaderStageInfo = {
@@ -603,14 +1592,17 @@ void HelloTriangleApplication::CreateGraphicsPipeline() {
         .pDynamicStates    = dynamicStates.data()
     };
 
+    const auto bindingDescription    = geometry::Vertex::GetBindingDescription();
+    const auto attributeDescriptions = geometry::Vertex::GetAttributeDescriptions();
+
     const VkPipelineVertexInputStateCreateInfo vertexInputInfo = {
         .sType                           = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO,
         .pNext                           = nullptr,
         .flags                           = {},
-        .vertexBindingDescriptionCount   = 0,
-        .pVertexBindingDescriptions      = nullptr,
-        .vertexAttributeDescriptionCount = 0,
-        .pVertexAttributeDescriptions    = nullptr
+        .vertexBindingDescriptionCount   = 1,
+        .pVertexBindingDescriptions      = &bindingDescription,
+        .vertexAttributeDescriptionCount = static_cast<uint32_t>(attributeDescriptions.size()),
+        .pVertexAttributeDescriptions    = attributeDescriptions.data()
     };
 
     const VkPipelineInputAssemblyStateCreateInfo inputAssembly = {
@@ -654,7 +1646,7 @@ void HelloTriangleApplication::CreateGraphicsPipeline() {
         .depthClampEnable        = VK_FALSE,
         .rasterizerDiscardEnable = VK_FALSE,
         .polygonMode             = VK_POLYGON_MODE_FILL,
-        .cullMode                = VK_CULL_MODE_BACK_BIT,
+        .cullMode                = m_settings.cullMode,
         .frontFace               = VK_FRONT_FACE_CLOCKWISE,
         .depthBiasEnable         = VK_FALSE,
         .depthBiasConstantFactor = 0.0F,  // Optional
@@ -675,9 +1667,21 @@ void HelloTriangleApplication::CreateGraphicsPipeline() {
         .alphaToOneEnable      = VK_FALSE   // Optional
     };
 
-    // Required if you are using a depth and/or stencil buffer.
-    // But we don't have one, so can pass nullptr later.
-    // VkPipelineDepthStencilStateCreateInfo:
+    // Only passed with a depth buffer. With LESS the instance drawn first wins where two have the same depth.
+    const VkPipelineDepthStencilStateCreateInfo depthStencil = {
+        .sType                 = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO,
+        .pNext                 = nullptr,
+        .flags                 = {},
+        .depthTestEnable       = VK_TRUE,
+        .depthWriteEnable      = VK_TRUE,
+        .depthCompareOp        = VK_COMPARE_OP_LESS,
+        .depthBoundsTestEnable = VK_FALSE,
+        .stencilTestEnable     = VK_FALSE,
+        .front                 = {},
+        .back                  = {},
+        .minDepthBounds        = 0.0F,
+        .maxDepthBounds        = 1.0F
+    };
 
     const VkPipelineColorBlendAttachmentState colorBlendAttachment = {
         // .blendEnable         = VK_TRUE;
@@ -687,13 +1691,13 @@ void HelloTriangleApplication::CreateGraphicsPipeline() {
         // .srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
         // .dstAlphaBlendFactor = VK_BLEND_FACTOR_ZERO;
         // .alphaBlendOp        = VK_BLEND_OP_ADD;
-        .blendEnable         = VK_FALSE,
-        .srcColorBlendFactor = VK_BLEND_FACTOR_ONE,   // Optional
-        .dstColorBlendFactor = VK_BLEND_FACTOR_ZERO,  // Optional
-        .colorBlendOp        = VK_BLEND_OP_ADD,       // Optional
-        .srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE,   // Optional
-        .dstAlphaBlendFactor = VK_BLEND_FACTOR_ZERO,  // Optional
-        .alphaBlendOp        = VK_BLEND_OP_ADD,       // Optional
+        .blendEnable         = m_settings.blend ? VK_TRUE : VK_FALSE,
+        .srcColorBlendFactor = m_settings.blend ? VK_BLEND_FACTOR_SRC_ALPHA : VK_BLEND_FACTOR_ONE,
+        .dstColorBlendFactor = m_settings.blend ? VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA : VK_BLEND_FACTOR_ZERO,
+        .colorBlendOp        = VK_BLEND_OP_ADD,
+        .srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE,
+        .dstAlphaBlendFactor = VK_BLEND_FACTOR_ZERO,
+        .alphaBlendOp        = VK_BLEND_OP_ADD,
         .colorWriteMask      = static_cast<VkColorComponentFlags>(VK_COLOR_COMPONENT_R_BIT) |
                                static_cast<VkColorComponentFlags>(VK_COLOR_COMPONENT_G_BIT) |
                                static_cast<VkColorComponentFlags>(VK_COLOR_COMPONENT_B_BIT) |
@@ -710,25 +1714,22 @@ void HelloTriangleApplication::CreateGraphicsPipeline() {
         .pAttachments      = &colorBlendAttachment,
         .blendConstants    = { 0.0F, 0.0F, 0.0F, 0.0F }  // Optional
     };
-
-    const VkPipelineLayoutCreateInfo pipelineLayoutInfo = {
-        .sType                  = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
-        .pNext                  = nullptr,
-        .flags                  = {},
-        .setLayoutCount         = 0,        // Optional
-        .pSetLayouts            = nullptr,  // Optional
-        .pushConstantRangeCount = 0,        // Optional
-        .pPushConstantRanges    = nullptr   // Optional
-    };
     // clang-format on
 
-    if (const auto& result = vkCreatePipelineLayout(m_device, &pipelineLayoutInfo, nullptr, &m_pipelineLayout) != VK_SUCCESS) {
-        throw std::runtime_error(std::format("{}::CreateGraphicsPipeline: Failed to create pipeline layout, error code: {}.", kClassName, result));
-    }
+    // Without a render pass, the attachment formats the pipeline renders to are declared here instead.
+    const VkPipelineRenderingCreateInfo renderingInfo = {
+        .sType                   = VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO,
+        .pNext                   = nullptr,
+        .viewMask                = 0,
+        .colorAttachmentCount    = 1,
+        .pColorAttachmentFormats = &colorFormat,
+        .depthAttachmentFormat   = m_depthFormat,
+        .stencilAttachmentFormat = VK_FORMAT_UNDEFINED
+    };
 
     const VkGraphicsPipelineCreateInfo pipelineInfo = {
         .sType               = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO,
-        .pNext               = nullptr,
+        .pNext               = m_dynamicRendering ? &renderingInfo : nullptr,
         .flags               = {},
         .stageCount          = 2,
         .pStages             = shaderStages.data(),
@@ -738,32 +1739,171 @@ void HelloTriangleApplication::CreateGraphicsPipeline() {
         .pViewportState      = &viewportState,
         .pRasterizationState = &rasterizer,
         .pMultisampleState   = &multisampling,
-        .pDepthStencilState  = nullptr,  // Optional
+        .pDepthStencilState  = UsesDepthBuffer() ? &depthStencil : nullptr,
         .pColorBlendState    = &colorBlending,
         .pDynamicState       = &dynamicState,
         .layout              = m_pipelineLayout,
-        .renderPass          = m_renderPass,
+        .renderPass          = m_renderPass,  // VK_NULL_HANDLE with dynamic rendering.
         .subpass             = 0,
         .basePipelineHandle  = VK_NULL_HANDLE,  // Optional
         .basePipelineIndex   = -1               // Optional
     };
 
-    if (const auto& result = vkCreateGraphicsPipelines(m_device, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &m_graphicsPipeline) != VK_SUCCESS) {
-        throw std::runtime_error(std::format("{}::CreateGraphicsPipeline: Failed to create graphic pipeline, error code: {}.", kClassName, result));
-    }
+    VkPipeline pipeline = VK_NULL_HANDLE;
+    const auto result   = vkCreateGraphicsPipelines(m_device, m_pipelineCache, 1, &pipelineInfo, nullptr, &pipeline);
 
     vkDestroyShaderModule(m_device, fragShaderModule, nullptr);
     vkDestroyShaderModule(m_device, vertShaderModule, nullptr);
+
+    if (VK_SUCCESS != result) {
+        throw std::runtime_error(std::format("{}::BuildGraphicsPipeline: Failed to create graphic pipeline, error code: {}.", kClassName, static_cast<int32_t>(result)));
+    }
+
+    return pipeline;
 }
 
-auto HelloTriangleApplication::CreateShaderModule(const std::vector<char>& code) -> VkShaderModule {
+auto HelloTriangleApplication::SelectGraphicsPipeline() -> VkPipeline {
+    if (0 == m_settings.colorModeCycle) {
+        return m_graphicsPipeline;
+    }
+
+    const uint64_t startMode = static_cast<uint64_t>(m_settings.colorMode);
+    const uint64_t cycle     = m_frameNumber / m_settings.colorModeCycle;
+    const auto     colorMode = static_cast<uint32_t>((startMode + cycle) % kColorModeCount);
+
+    // The next mode in the cycle is requested a whole cycle ahead, so usually it is compiled before the first frame that draws with it.
+    const auto nextColorMode = static_cast<uint32_t>((startMode + cycle + 1) % kColorModeCount);
+    if (startMode != nextColorMode) {
+        m_pipelineVariants->Request(nextColorMode);
+    }
+
+    if (static_cast<uint32_t>(m_settings.colorMode) == colorMode) {
+        return m_graphicsPipeline;
+    }
+
+    // Never wait for a compile, the frame is drawn with the startup variant until the one it asked for is published.
+    const VkPipeline pipeline = m_pipelineVariants->Acquire(colorMode);
+    if (VK_NULL_HANDLE == pipeline) {
+        m_fallbackFrames++;
+        return m_graphicsPipeline;
+    }
+
+    return pipeline;
+}
+
+void HelloTriangleApplication::CreateCullPipeline() {
+    VT_TRACE_ZONE("CreateCullPipeline");
+
+    VkPhysicalDeviceProperties properties = {};
+    vkGetPhysicalDeviceProperties(m_physicalDevice, &properties);
+    if ((m_settings.instanceCount + kCullWorkgroupSize - 1) / kCullWorkgroupSize > properties.limits.maxComputeWorkGroupCount[0]) {
+        throw std::runtime_error(std::format("{}::CreateCullPipeline: {} instances exceed maxComputeWorkGroupCount ({} workgroups of {}).", kClassName,
+                                             m_settings.instanceCount, properties.limits.maxComputeWorkGroupCount[0], kCullWorkgroupSize));
+    }
+
+    VkShaderModule cullShaderModule = CreateShaderModule("cull.comp", shaders::kCullComp);
+
+    const VkPushConstantRange        constantsRange     = { .stageFlags = VK_SHADER_STAGE_COMPUTE_BIT, .offset = 0, .size = sizeof(geometry::CullConstants) };
+    const VkPipelineLayoutCreateInfo pipelineLayoutInfo = { .sType                  = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
+                                                            .pNext                  = nullptr,
+                                                            .flags                  = {},
+                                                            .setLayoutCount         = 1,
+                                                            .pSetLayouts            = &m_cullDescriptorSetLayout,
+                                                            .pushConstantRangeCount = 1,
+                                                            .pPushConstantRanges    = &constantsRange };
+
+    if (const auto& result = vkCreatePipelineLayout(m_device, &pipelineLayoutInfo, nullptr, &m_cullPipelineLayout) != VK_SUCCESS) {
+        throw std::runtime_error(std::format("{}::CreateCullPipeline: Failed to create pipeline layout, error code: {}.", kClassName, result));
+    }
+
+    const VkComputePipelineCreateInfo pipelineInfo = { .sType              = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO,
+                                                       .pNext              = nullptr,
+                                                       .flags              = {},
+                                                       .stage              = { .sType               = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
+                                                                               .pNext               = nullptr,
+                                                                               .flags               = {},
+                                                                               .stage               = VK_SHADER_STAGE_COMPUTE_BIT,
+                                                                               .module              = cullShaderModule,
+                                                                               .pName               = "main",
+                                                                               .pSpecializationInfo = nullptr },
+                                                       .layout             = m_cullPipelineLayout,
+                                                       .basePipelineHandle = VK_NULL_HANDLE,
+                                                       .basePipelineIndex  = -1 };
+
+    if (const auto& result = vkCreateComputePipelines(m_device, m_pipelineCache, 1, &pipelineInfo, nullptr, &m_cullPipeline) != VK_SUCCESS) {
+        throw std::runtime_error(std::format("{}::CreateCullPipeline: Failed to create compute pipeline, error code: {}.", kClassName, result));
+    }
+
+    vkDestroyShaderModule(m_device, cullShaderModule, nullptr);
+}
+
+void HelloTriangleApplication::CreateAnimatePipeline() {
+    VT_TRACE_ZONE("CreateAnimatePipeline");
+
+    // A recorded dispatch would animate every submit with the same phase, and CPU culling tests a CPU copy of the instances that never moves.
+    if (m_settings.staticScene || CullingMode::CPU == m_settings.culling) {
+        throw std::runtime_error(std::format("{}::CreateAnimatePipeline: Animated instances are not supported with a static scene or CPU culling.", kClassName));
+    }
+
+    VkPhysicalDeviceProperties properties = {};
+    vkGetPhysicalDeviceProperties(m_physicalDevice, &properties);
+    if ((m_settings.instanceCount + kAnimateWorkgroupSize - 1) / kAnimateWorkgroupSize > properties.limits.maxComputeWorkGroupCount[0]) {
+        throw std::runtime_error(std::format("{}::CreateAnimatePipeline: {} instances exceed maxComputeWorkGroupCount ({} workgroups of {}).", kClassName,
+                                             m_settings.instanceCount, properties.limits.maxComputeWorkGroupCount[0], kAnimateWorkgroupSize));
+    }
+
+    VkShaderModule animateShaderModule = CreateShaderModule("animate.comp", shaders::kAnimateComp);
+
+    const VkPushConstantRange        constantsRange     = { .stageFlags = VK_SHADER_STAGE_COMPUTE_BIT, .offset = 0, .size = sizeof(geometry::AnimationConstants) };
+    const VkPipelineLayoutCreateInfo pipelineLayoutInfo = { .sType                  = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
+                                                            .pNext                  = nullptr,
+                                                            .flags                  = {},
+                                                            .setLayoutCount         = 1,
+                                                            .pSetLayouts            = &m_descriptorSetLayout,
+                                                            .pushConstantRangeCount = 1,
+                                                            .pPushConstantRanges    = &constantsRange };
+
+    if (const auto& result = vkCreatePipelineLayout(m_device, &pipelineLayoutInfo, nullptr, &m_animatePipelineLayout) != VK_SUCCESS) {
+        throw std::runtime_error(std::format("{}::CreateAnimatePipeline: Failed to create pipeline layout, error code: {}.", kClassName, result));
+    }
+
+    const VkComputePipelineCreateInfo pipelineInfo = { .sType              = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO,
+                                                       .pNext              = nullptr,
+                                                       .flags              = {},
+                                                       .stage              = { .sType               = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
+                                                                               .pNext               = nullptr,
+                                                                               .flags               = {},
+                                                                               .stage               = VK_SHADER_STAGE_COMPUTE_BIT,
+                                                                               .module              = animateShaderModule,
+                                                                               .pName               = "main",
+                                                                               .pSpecializationInfo = nullptr },
+                                                       .layout             = m_animatePipelineLayout,
+                                                       .basePipelineHandle = VK_NULL_HANDLE,
+                                                       .basePipelineIndex  = -1 };
+
+    if (const auto& result = vkCreateComputePipelines(m_device, m_pipelineCache, 1, &pipelineInfo, nullptr, &m_animatePipeline) != VK_SUCCESS) {
+        throw std::runtime_error(std::format("{}::CreateAnimatePipeline: Failed to create compute pipeline, error code: {}.", kClassName, result));
+    }
+
+    vkDestroyShaderModule(m_device, animateShaderModule, nullptr);
+}
+
+auto HelloTriangleApplication::CreateShaderModule(std::string_view name, std::span<const uint32_t> embeddedCode) -> VkShaderModule {
+    // The SPIR-V compiled into the binary is used in place, only the development override reads from disk.
+    std::vector<uint32_t>     fileCode;
+    std::span<const uint32_t> code = embeddedCode;
+    if (!m_settings.shaderDirectory.empty()) {
+        fileCode = utilities::ReadSpirvFile((std::filesystem::path(m_settings.shaderDirectory) / std::format("{}.spv", name)).string());
+        code     = fileCode;
+    }
+
     // clang-format off
     const VkShaderModuleCreateInfo createInfo = {
         .sType    = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO,
         .pNext    = nullptr,
         .flags    = {},
-        .codeSize = code.size(),
-        .pCode    = reinterpret_cast<const uint32_t*>(code.data())
+        .codeSize = code.size_bytes(),
+        .pCode    = code.data()
     };
     // clang-format on
 
@@ -776,15 +1916,17 @@ auto HelloTriangleApplication::CreateShaderModule(const std::vector<char>& code)
 }
 
 void HelloTriangleApplication::CreateFramebuffers() {
+    VT_TRACE_ZONE("CreateFramebuffers");
+
     m_swapChainFramebuffers.resize(m_swapChainImageViews.size());
 
     for (size_t i = 0; i < m_swapChainImageViews.size(); i++) {
-        std::array<VkImageView, 1>    attachments     = { m_swapChainImageViews[i] };
+        std::array<VkImageView, 2>    attachments     = { m_swapChainImageViews[i], m_depthImageView };
         const VkFramebufferCreateInfo framebufferInfo = { .sType           = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO,
                                                           .pNext           = nullptr,
                                                           .flags           = {},
                                                           .renderPass      = m_renderPass,
-                                                          .attachmentCount = 1,
+                                                          .attachmentCount = UsesDepthBuffer() ? 2U : 1U,
                                                           .pAttachments    = attachments.data(),
                                                           .width           = m_swapChainExtent.width,
                                                           .height          = m_swapChainExtent.height,
@@ -797,6 +1939,8 @@ void HelloTriangleApplication::CreateFramebuffers() {
 }
 
 void HelloTriangleApplication::CreateCommandPool() {
+    VT_TRACE_ZONE("CreateCommandPool");
+
     QueueFamilyIndices queueFamilyIndices = FindQueueFamilies(m_physicalDevice);
 
     const VkCommandPoolCreateInfo poolInfo = { .sType            = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
@@ -809,27 +1953,290 @@ void HelloTriangleApplication::CreateCommandPool() {
     }
 }
 
+void HelloTriangleApplication::CreateGeometryBuffers() {
+    VT_TRACE_ZONE("CreateGeometryBuffers");
+
+    auto instances = geometry::MakeInstanceGrid(m_settings.instanceCount, m_settings.instanceScale);
+
+    // The instance depths never change and the camera only pans and zooms, so sorting once here orders the draws of every frame.
+    // Instanced and CPU culled draws keep the buffer order, GPU culling compacts the visible instances with atomics, which only roughly keeps it.
+    // Animated instances are written by animate.comp in grid order, so there is nothing to sort.
+    if (DrawOrder::UNSORTED != m_settings.drawOrder && !m_settings.animateInstances) {
+        geometry::SortByDepth(instances, DrawOrder::FRONT_TO_BACK == m_settings.drawOrder);
+    }
+
+    const VkDeviceSize vertexSize   = sizeof(geometry::Vertex) * geometry::kTriangleVertices.size();
+    const VkDeviceSize indexSize    = sizeof(geometry::Index) * geometry::kTriangleIndices.size();
+    const VkDeviceSize instanceSize = sizeof(geometry::InstanceData) * instances.size();
+
+    VkPhysicalDeviceProperties properties = {};
+    vkGetPhysicalDeviceProperties(m_physicalDevice, &properties);
+    if (instanceSize > properties.limits.maxStorageBufferRange) {
+        throw std::runtime_error(std::format("{}::CreateGeometryBuffers: {} instances exceed maxStorageBufferRange ({} bytes).", kClassName, instances.size(),
+                                             properties.limits.maxStorageBufferRange));
+    }
+
+    const auto transferDst = static_cast<VkBufferUsageFlags>(VK_BUFFER_USAGE_TRANSFER_DST_BIT);
+    m_vertexBuffer         = m_allocator->CreateBuffer(vertexSize, transferDst | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+    m_indexBuffer          = m_allocator->CreateBuffer(indexSize, transferDst | VK_BUFFER_USAGE_INDEX_BUFFER_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+    m_instanceBuffer       = m_allocator->CreateBuffer(instanceSize, transferDst | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+
+    // Room for a draw per instance, cull.comp compacts the visible ones to the front and counts them.
+    if (CullingMode::GPU == m_settings.culling) {
+        const auto indirectUsage = static_cast<VkBufferUsageFlags>(VK_BUFFER_USAGE_STORAGE_BUFFER_BIT) | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT;
+        m_drawCommandBuffer      = m_allocator->CreateBuffer(sizeof(VkDrawIndexedIndirectCommand) * instances.size(), indirectUsage,
+                                                             VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+        m_drawCountBuffer        = m_allocator->CreateBuffer(sizeof(uint32_t), transferDst | indirectUsage, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+    }
+
+    // The copies run on the transfer queue and are handed over to the graphics queue by the first frame, so initialization doesn't wait for them.
+    m_uploader->Upload(m_vertexBuffer.buffer, 0, std::as_bytes(std::span(geometry::kTriangleVertices)), VK_PIPELINE_STAGE_2_VERTEX_INPUT_BIT,
+                       VK_ACCESS_2_VERTEX_ATTRIBUTE_READ_BIT);
+    m_uploader->Upload(m_indexBuffer.buffer, 0, std::as_bytes(std::span(geometry::kTriangleIndices)), VK_PIPELINE_STAGE_2_VERTEX_INPUT_BIT,
+                       VK_ACCESS_2_INDEX_READ_BIT);
+    if (!m_settings.animateInstances) {
+        m_uploader->Upload(m_instanceBuffer.buffer, 0, std::as_bytes(std::span(instances)),
+                           VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_STORAGE_READ_BIT);
+    }
+    m_uploader->Flush();
+
+    if (CullingMode::CPU == m_settings.culling) {
+        m_instances = std::move(instances);
+    }
+}
+
+void HelloTriangleApplication::CreateDescriptorSetLayout() {
+    VT_TRACE_ZONE("CreateDescriptorSetLayout");
+
+    // animate.comp writes the instances through the same set the vertex shader reads them from.
+    VkShaderStageFlags instanceStages = VK_SHADER_STAGE_VERTEX_BIT;
+    if (m_settings.animateInstances) {
+        instanceStages |= VK_SHADER_STAGE_COMPUTE_BIT;
+    }
+
+    const VkDescriptorSetLayoutBinding instanceBinding = { .binding            = 0,
+                                                           .descriptorType     = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+                                                           .descriptorCount    = 1,
+                                                           .stageFlags         = instanceStages,
+                                                           .pImmutableSamplers = nullptr };
+
+    const VkDescriptorSetLayoutCreateInfo layoutInfo = { .sType        = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
+                                                         .pNext        = nullptr,
+                                                         .flags        = {},
+                                                         .bindingCount = 1,
+                                                         .pBindings    = &instanceBinding };
+
+    if (const auto& result = vkCreateDescriptorSetLayout(m_device, &layoutInfo, nullptr, &m_descriptorSetLayout) != VK_SUCCESS) {
+        throw std::runtime_error(std::format("{}::CreateDescriptorSetLayout: Failed to create descriptor set layout, error code: {}.", kClassName, result));
+    }
+
+    if (CullingMode::GPU != m_settings.culling) {
+        return;
+    }
+
+    // cull.comp reads the instances (binding 0) and writes the draw commands (binding 1) and their count (binding 2).
+    std::array<VkDescriptorSetLayoutBinding, 3> cullBindings = {};
+    for (uint32_t binding = 0; binding < cullBindings.size(); binding++) {
+        cullBindings[binding] = { .binding            = binding,
+                                  .descriptorType     = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+                                  .descriptorCount    = 1,
+                                  .stageFlags         = VK_SHADER_STAGE_COMPUTE_BIT,
+                                  .pImmutableSamplers = nullptr };
+    }
+
+    const VkDescriptorSetLayoutCreateInfo cullLayoutInfo = { .sType        = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
+                                                             .pNext        = nullptr,
+                                                             .flags        = {},
+                                                             .bindingCount = static_cast<uint32_t>(cullBindings.size()),
+                                                             .pBindings    = cullBindings.data() };
+
+    if (const auto& result = vkCreateDescriptorSetLayout(m_device, &cullLayoutInfo, nullptr, &m_cullDescriptorSetLayout) != VK_SUCCESS) {
+        throw std::runtime_error(std::format("{}::CreateDescriptorSetLayout: Failed to create cull descriptor set layout, error code: {}.", kClassName, result));
+    }
+}
+
+void HelloTriangleApplication::CreateDescriptorSet() {
+    VT_TRACE_ZONE("CreateDescriptorSet");
+
+    // The buffers never change after their creation, so a single set per pipeline is shared by every frame in flight.
+    const bool                       gpuCulling = CullingMode::GPU == m_settings.culling;
+    const VkDescriptorPoolSize       poolSize   = { .type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, .descriptorCount = gpuCulling ? 4U : 1U };
+    const VkDescriptorPoolCreateInfo poolInfo   = { .sType         = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO,
+                                                    .pNext         = nullptr,
+                                                    .flags         = {},
+                                                    .maxSets       = gpuCulling ? 2U : 1U,
+                                                    .poolSizeCount = 1,
+                                                    .pPoolSizes    = &poolSize };
+
+    if (const auto& result = vkCreateDescriptorPool(m_device, &poolInfo, nullptr, &m_descriptorPool) != VK_SUCCESS) {
+        throw std::runtime_error(std::format("{}::CreateDescriptorSet: Failed to create descriptor pool, error code: {}.", kClassName, result));
+    }
+
+    const VkDescriptorSetAllocateInfo allocInfo = { .sType              = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO,
+                                                    .pNext              = nullptr,
+                                                    .descriptorPool     = m_descriptorPool,
+                                                    .descriptorSetCount = 1,
+                                                    .pSetLayouts        = &m_descriptorSetLayout };
+
+    if (const auto& result = vkAllocateDescriptorSets(m_device, &allocInfo, &m_descriptorSet) != VK_SUCCESS) {
+        throw std::runtime_error(std::format("{}::CreateDescriptorSet: Failed to allocate descriptor set, error code: {}.", kClassName, result));
+    }
+
+    const VkDescriptorBufferInfo bufferInfo = { .buffer = m_instanceBuffer.buffer, .offset = 0, .range = VK_WHOLE_SIZE };
+    const VkWriteDescriptorSet   write      = { .sType            = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+                                                .pNext            = nullptr,
+                                                .dstSet           = m_descriptorSet,
+                                                .dstBinding       = 0,
+                                                .dstArrayElement  = 0,
+                                                .descriptorCount  = 1,
+                                                .descriptorType   = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+                                                .pImageInfo       = nullptr,
+                                                .pBufferInfo      = &bufferInfo,
+                                                .pTexelBufferView = nullptr };
+
+    vkUpdateDescriptorSets(m_device, 1, &write, 0, nullptr);
+
+    if (!gpuCulling) {
+        return;
+    }
+
+    const VkDescriptorSetAllocateInfo cullAllocInfo = { .sType              = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO,
+                                                        .pNext              = nullptr,
+                                                        .descriptorPool     = m_descriptorPool,
+                                                        .descriptorSetCount = 1,
+                                                        .pSetLayouts        = &m_cullDescriptorSetLayout };
+
+    if (const auto& result = vkAllocateDescriptorSets(m_device, &cullAllocInfo, &m_cullDescriptorSet) != VK_SUCCESS) {
+        throw std::runtime_error(std::format("{}::CreateDescriptorSet: Failed to allocate cull descriptor set, error code: {}.", kClassName, result));
+    }
+
+    const std::array<VkDescriptorBufferInfo, 3> cullBufferInfos = { { { .buffer = m_instanceBuffer.buffer, .offset = 0, .range = VK_WHOLE_SIZE },
+                                                                      { .buffer = m_drawCommandBuffer.buffer, .offset = 0, .range = VK_WHOLE_SIZE },
+                                                                      { .buffer = m_drawCountBuffer.buffer, .offset = 0, .range = VK_WHOLE_SIZE } } };
+
+    std::array<VkWriteDescriptorSet, 3> cullWrites = {};
+    for (uint32_t binding = 0; binding < cullWrites.size(); binding++) {
+        cullWrites[binding]             = write;
+        cullWrites[binding].dstSet      = m_cullDescriptorSet;
+        cullWrites[binding].dstBinding  = binding;
+        cullWrites[binding].pBufferInfo = &cullBufferInfos[binding];
+    }
+
+    vkUpdateDescriptorSets(m_device, static_cast<uint32_t>(cullWrites.size()), cullWrites.data(), 0, nullptr);
+}
+
+void HelloTriangleApplication::CreateUploader() {
+    VT_TRACE_ZONE("CreateUploader");
+
+    QueueFamilyIndices indices = FindQueueFamilies(m_physicalDevice);
+    m_uploader = std::make_unique<memory::Uploader>(m_device, *m_allocator, m_transferQueue, indices.GetTransferFamilyValue(), indices.GetGraphicsFamilyValue());
+}
+
 void HelloTriangleApplication::CreateCommandBuffers() {
+    VT_TRACE_ZONE("CreateCommandBuffers");
+
+    if (0 == m_settings.framesInFlight || m_settings.framesInFlight > kMaxFramesInFlight) {
+        throw std::runtime_error(std::format("{}::CreateCommandBuffers: Frames in flight must be in [1, {}], got {}.", kClassName, kMaxFramesInFlight,
+                                             m_settings.framesInFlight));
+    }
+
+    m_frames.resize(m_settings.framesInFlight);
+    std::vector<VkCommandBuffer> commandBuffers(m_frames.size() * 3);
+
     // clang-format off
     const VkCommandBufferAllocateInfo allocInfo = {
         .sType              = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
         .pNext              = nullptr,
         .commandPool        = m_commandPool,
         .level              = VK_COMMAND_BUFFER_LEVEL_PRIMARY,
-        .commandBufferCount = 1
+        .commandBufferCount = static_cast<uint32_t>(commandBuffers.size())
     };
     // clang-format on
 
-    if (const auto& result = vkAllocateCommandBuffers(m_device, &allocInfo, &m_commandBuffer) != VK_SUCCESS) {
+    if (const auto& result = vkAllocateCommandBuffers(m_device, &allocInfo, commandBuffers.data()) != VK_SUCCESS) {
         throw std::runtime_error(std::format("{}::CreateCommandBuffers: Failed to create command buffer, error code: {}.", kClassName, result));
     }
+
+    for (size_t i = 0; i < m_frames.size(); i++) {
+        m_frames[i].commandBuffer        = commandBuffers[i * 3];
+        m_frames[i].acquireCommandBuffer = commandBuffers[(i * 3) + 1];
+        m_frames[i].captureCommandBuffer = commandBuffers[(i * 3) + 2];
+    }
+
+    // One region of the upload stream per frame slot, a slot is only rewritten once the frame that last used it has finished.
+    if (0 != m_settings.uploadStreamKiB) {
+        const VkDeviceSize slotSize = VkDeviceSize { m_settings.uploadStreamKiB } * 1024;
+        m_streamData.assign(slotSize, std::byte { 0x5A });
+        m_streamBuffer = m_allocator->CreateBuffer(slotSize * m_frames.size(),
+                                                   static_cast<VkBufferUsageFlags>(VK_BUFFER_USAGE_TRANSFER_DST_BIT) | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+                                                   VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+    }
+
+    // Static scenes are recorded once up front, so they have no use for recording threads.
+    if (0 == m_settings.recordThreads || m_settings.staticScene) {
+        return;
+    }
+
+    m_recordThreadPool = std::make_unique<threading::ThreadPool>(m_settings.recordThreads);
+
+    QueueFamilyIndices            queueFamilyIndices = FindQueueFamilies(m_physicalDevice);
+    const VkCommandPoolCreateInfo poolInfo           = { .sType            = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
+                                                         .pNext            = nullptr,
+                                                         .flags            = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT,
+                                                         .queueFamilyIndex = queueFamilyIndices.GetGraphicsFamilyValue() };
+
+    for (auto& frame : m_frames) {
+        frame.workerCommandPools.resize(m_settings.recordThreads);
+        frame.secondaryCommandBuffers.resize(m_settings.recordThreads);
+
+        for (uint32_t worker = 0; worker < m_settings.recordThreads; worker++) {
+            if (const auto& result = vkCreateCommandPool(m_device, &poolInfo, nullptr, &frame.workerCommandPools[worker]) != VK_SUCCESS) {
+                throw std::runtime_error(std::format("{}::CreateCommandBuffers: Failed to create worker command pool, error code: {}.", kClassName, result));
+            }
+
+            const VkCommandBufferAllocateInfo secondaryInfo = { .sType              = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+                                                                .pNext              = nullptr,
+                                                                .commandPool        = frame.workerCommandPools[worker],
+                                                                .level              = VK_COMMAND_BUFFER_LEVEL_SECONDARY,
+                                                                .commandBufferCount = 1 };
+
+            if (const auto& result = vkAllocateCommandBuffers(m_device, &secondaryInfo, &frame.secondaryCommandBuffers[worker]) != VK_SUCCESS) {
+                throw std::runtime_error(std::format("{}::CreateCommandBuffers: Failed to create secondary command buffer, error code: {}.", kClassName, result));
+            }
+        }
+    }
 }
 
-void HelloTriangleApplication::RecordCommandBuffer(VkCommandBuffer commandBuffer, uint32_t imageIndex) {
+void HelloTriangleApplication::RecordStaticCommandBuffers() {
+    VT_TRACE_ZONE("RecordStaticCommandBuffers");
+
+    m_staticCommandBuffers.resize(m_swapChainImageViews.size());
+
+    // clang-format off
+    const VkCommandBufferAllocateInfo allocInfo = {
+        .sType              = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+        .pNext              = nullptr,
+        .commandPool        = m_commandPool,
+        .level              = VK_COMMAND_BUFFER_LEVEL_PRIMARY,
+        .commandBufferCount = static_cast<uint32_t>(m_staticCommandBuffers.size())
+    };
+    // clang-format on
+
+    if (const auto& result = vkAllocateCommandBuffers(m_device, &allocInfo, m_staticCommandBuffers.data()) != VK_SUCCESS) {
+        throw std::runtime_error(std::format("{}::RecordStaticCommandBuffers: Failed to allocate command buffers, error code: {}.", kClassName, result));
+    }
+
+    // An image can be re-acquired before the work that last rendered to it has retired, hence simultaneous use.
+    for (size_t i = 0; i < m_staticCommandBuffers.size(); i++) {
+        RecordCommandBuffer(m_staticCommandBuffers[i], static_cast<uint32_t>(i), VK_COMMAND_BUFFER_USAGE_SIMULTANEOUS_USE_BIT);
+    }
+}
+
+void HelloTriangleApplication::RecordCommandBuffer(VkCommandBuffer commandBuffer, uint32_t imageIndex, VkCommandBufferUsageFlags usageFlags) {
     const VkCommandBufferBeginInfo beginInfo = {
         .sType            = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
         .pNext            = nullptr,
-        .flags            = {},      // Optional
+        .flags            = usageFlags,
         .pInheritanceInfo = nullptr  // Optional
     };
 
@@ -837,8 +2244,205 @@ void HelloTriangleApplication::RecordCommandBuffer(VkCommandBuffer commandBuffer
         throw std::runtime_error(std::format("{}::RecordCommandBuffer: Failed to begin recording command buffer, error code: {}.", kClassName, result));
     }
 
+    // Static command buffers are never re-recorded, so they are never timed, see CreateGpuTimer.
+    uint32_t frameRegion      = { 0 };
+    uint32_t renderPassRegion = { 0 };
+    if (nullptr != m_gpuTimer) {
+        m_gpuTimer->BeginFrame(commandBuffer, CurrentFrameIndex());
+        frameRegion = m_gpuTimer->BeginRegion(commandBuffer, "frame");
+    }
+    if (m_settings.animateInstances) {
+        RecordAnimation(commandBuffer);
+    }
+    if (CullingMode::GPU == m_settings.culling) {
+        RecordCulling(commandBuffer);
+    }
+    if (nullptr != m_gpuTimer) {
+        renderPassRegion = m_gpuTimer->BeginRegion(commandBuffer, "render pass");
+    }
+    if (nullptr != m_overdrawCounter) {
+        m_overdrawCounter->BeginFrame(commandBuffer, CurrentFrameIndex(), uint64_t { m_swapChainExtent.width } * m_swapChainExtent.height);
+        m_overdrawCounter->Begin(commandBuffer);
+    }
+    BeginRenderPass(commandBuffer, imageIndex, VK_SUBPASS_CONTENTS_INLINE);
+    RecordDraws(commandBuffer, 0, DrawItemCount());
+    EndRenderPass(commandBuffer, imageIndex);
+    if (nullptr != m_overdrawCounter) {
+        m_overdrawCounter->End(commandBuffer);
+    }
+    if (nullptr != m_gpuTimer) {
+        m_gpuTimer->EndRegion(commandBuffer, renderPassRegion);
+        m_gpuTimer->EndRegion(commandBuffer, frameRegion);
+    }
+
+    if (const auto& result = vkEndCommandBuffer(commandBuffer) != VK_SUCCESS) {
+        throw std::runtime_error(std::format("{}::RecordCommandBuffer: Failed to end command buffer, error code: {}.", kClassName, result));
+    }
+}
+
+void HelloTriangleApplication::RecordCommandBufferParallel(FrameData& frame, uint32_t imageIndex) {
+    // Each worker records an equal share of the draws into its own secondary command buffer, allocated from
+    // a command pool that only that worker touches, so no command pool synchronization is needed.
+    const uint32_t itemCount      = DrawItemCount();
+    const uint32_t workerCount    = m_recordThreadPool->Size();
+    const uint32_t drawsPerWorker = (itemCount + workerCount - 1) / workerCount;
+
+    m_recordThreadPool->RunOnAll([&](uint32_t worker) {
+        const uint32_t firstDraw = std::min(worker * drawsPerWorker, itemCount);
+        const uint32_t drawCount = std::min(drawsPerWorker, itemCount - firstDraw);
+        RecordSecondaryCommandBuffer(frame.workerCommandPools[worker], frame.secondaryCommandBuffers[worker], imageIndex, firstDraw, drawCount);
+    });
+
+    const VkCommandBufferBeginInfo beginInfo = { .sType            = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+                                                 .pNext            = nullptr,
+                                                 .flags            = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT,
+                                                 .pInheritanceInfo = nullptr };
+
+    if (const auto& result = vkBeginCommandBuffer(frame.commandBuffer, &beginInfo) != VK_SUCCESS) {
+        throw std::runtime_error(std::format("{}::RecordCommandBufferParallel: Failed to begin recording command buffer, error code: {}.", kClassName, result));
+    }
+
+    // Timestamps can't be written inside a render pass that executes secondary command buffers, so the regions wrap it from the primary.
+    uint32_t frameRegion      = { 0 };
+    uint32_t renderPassRegion = { 0 };
+    if (nullptr != m_gpuTimer) {
+        m_gpuTimer->BeginFrame(frame.commandBuffer, CurrentFrameIndex());
+        frameRegion = m_gpuTimer->BeginRegion(frame.commandBuffer, "frame");
+    }
+    if (m_settings.animateInstances) {
+        RecordAnimation(frame.commandBuffer);
+    }
+    if (CullingMode::GPU == m_settings.culling) {
+        RecordCulling(frame.commandBuffer);
+    }
+    if (nullptr != m_gpuTimer) {
+        renderPassRegion = m_gpuTimer->BeginRegion(frame.commandBuffer, "render pass");
+    }
+    if (nullptr != m_overdrawCounter) {
+        m_overdrawCounter->BeginFrame(frame.commandBuffer, CurrentFrameIndex(), uint64_t { m_swapChainExtent.width } * m_swapChainExtent.height);
+        m_overdrawCounter->Begin(frame.commandBuffer);
+    }
+
+    BeginRenderPass(frame.commandBuffer, imageIndex, VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS);
+    vkCmdExecuteCommands(frame.commandBuffer, static_cast<uint32_t>(frame.secondaryCommandBuffers.size()), frame.secondaryCommandBuffers.data());
+    EndRenderPass(frame.commandBuffer, imageIndex);
+    if (nullptr != m_overdrawCounter) {
+        m_overdrawCounter->End(frame.commandBuffer);
+    }
+    if (nullptr != m_gpuTimer) {
+        m_gpuTimer->EndRegion(frame.commandBuffer, renderPassRegion);
+        m_gpuTimer->EndRegion(frame.commandBuffer, frameRegion);
+    }
+
+    if (const auto& result = vkEndCommandBuffer(frame.commandBuffer) != VK_SUCCESS) {
+        throw std::runtime_error(std::format("{}::RecordCommandBufferParallel: Failed to end command buffer, error code: {}.", kClassName, result));
+    }
+}
+
+void HelloTriangleApplication::RecordSecondaryCommandBuffer(VkCommandPool commandPool, VkCommandBuffer commandBuffer, uint32_t imageIndex, uint32_t firstDraw,
+                                                            uint32_t drawCount) {
+    VT_TRACE_ZONE("RecordSecondaryCommandBuffer");
+
+    // Resetting the whole pool is cheaper than resetting its command buffers one by one.
+    vkResetCommandPool(m_device, commandPool, 0);
+
+    // With dynamic rendering a secondary command buffer inherits the attachment formats instead of a render pass and framebuffer.
+    const VkCommandBufferInheritanceRenderingInfo renderingInfo = { .sType                   = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_RENDERING_INFO,
+                                                                    .pNext                   = nullptr,
+                                                                    .flags                   = {},
+                                                                    .viewMask                = 0,
+                                                                    .colorAttachmentCount    = 1,
+                                                                    .pColorAttachmentFormats = &m_swapChainImageFormat,
+                                                                    .depthAttachmentFormat   = m_depthFormat,
+                                                                    .stencilAttachmentFormat = VK_FORMAT_UNDEFINED,
+                                                                    .rasterizationSamples    = VK_SAMPLE_COUNT_1_BIT };
+
+    // The overdraw counter's query is active in the primary command buffer while this one executes.
+    const VkQueryPipelineStatisticFlags inheritedStatistics = nullptr != m_overdrawCounter ? VK_QUERY_PIPELINE_STATISTIC_FRAGMENT_SHADER_INVOCATIONS_BIT : 0U;
+
+    const VkCommandBufferInheritanceInfo inheritanceInfo = { .sType                = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO,
+                                                             .pNext                = m_dynamicRendering ? &renderingInfo : nullptr,
+                                                             .renderPass           = m_renderPass,
+                                                             .subpass              = 0,
+                                                             .framebuffer          = m_dynamicRendering ? VK_NULL_HANDLE : m_swapChainFramebuffers[imageIndex],
+                                                             .occlusionQueryEnable = VK_FALSE,
+                                                             .queryFlags           = {},
+                                                             .pipelineStatistics   = inheritedStatistics };
+
+    const VkCommandBufferBeginInfo beginInfo = { .sType            = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+                                                 .pNext            = nullptr,
+                                                 .flags            = static_cast<VkCommandBufferUsageFlags>(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT) |
+                                                                     static_cast<VkCommandBufferUsageFlags>(VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT),
+                                                 .pInheritanceInfo = &inheritanceInfo };
+
+    if (const auto& result = vkBeginCommandBuffer(commandBuffer, &beginInfo) != VK_SUCCESS) {
+        throw std::runtime_error(std::format("{}::RecordSecondaryCommandBuffer: Failed to begin recording command buffer, error code: {}.", kClassName, result));
+    }
+
+    RecordDraws(commandBuffer, firstDraw, drawCount);
+
+    if (const auto& result = vkEndCommandBuffer(commandBuffer) != VK_SUCCESS) {
+        throw std::runtime_error(std::format("{}::RecordSecondaryCommandBuffer: Failed to end command buffer, error code: {}.", kClassName, result));
+    }
+}
+
+void HelloTriangleApplication::BeginRenderPass(VkCommandBuffer commandBuffer, uint32_t imageIndex, VkSubpassContents contents) {
+    const std::array<VkClearValue, 2> clearValues = { { { .color = { { 0.0F, 0.0F, 0.0F, 1.0F } } }, { .depthStencil = { .depth = 1.0F, .stencil = 0 } } } };
+
+    if (m_dynamicRendering) {
+        // The layout transition the render pass does implicitly, including the wait on the image available semaphore at the color attachment stage.
+        RecordImageBarrier(commandBuffer, m_swapChainImages[imageIndex], VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+                           VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT, VK_ACCESS_2_NONE, VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT,
+                           VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT);
+
+        // Likewise for the depth buffer, whose clear has to wait for the depth writes of the previous frame.
+        if (UsesDepthBuffer()) {
+            const VkPipelineStageFlags2 fragmentTests = VK_PIPELINE_STAGE_2_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_2_LATE_FRAGMENT_TESTS_BIT;
+            RecordImageBarrier(commandBuffer, m_depthImage.image, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL, fragmentTests,
+                               VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT, fragmentTests,
+                               VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT, VK_IMAGE_ASPECT_DEPTH_BIT);
+        }
+
+        const VkRenderingAttachmentInfo colorAttachment = { .sType              = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO,
+                                                            .pNext              = nullptr,
+                                                            .imageView          = m_swapChainImageViews[imageIndex],
+                                                            .imageLayout        = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+                                                            .resolveMode        = VK_RESOLVE_MODE_NONE,
+                                                            .resolveImageView   = VK_NULL_HANDLE,
+                                                            .resolveImageLayout = VK_IMAGE_LAYOUT_UNDEFINED,
+                                                            .loadOp             = VK_ATTACHMENT_LOAD_OP_CLEAR,
+                                                            .storeOp            = VK_ATTACHMENT_STORE_OP_STORE,
+                                                            .clearValue         = clearValues[0] };
+
+        const VkRenderingAttachmentInfo depthAttachment = { .sType              = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO,
+                                                            .pNext              = nullptr,
+                                                            .imageView          = m_depthImageView,
+                                                            .imageLayout        = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
+                                                            .resolveMode        = VK_RESOLVE_MODE_NONE,
+                                                            .resolveImageView   = VK_NULL_HANDLE,
+                                                            .resolveImageLayout = VK_IMAGE_LAYOUT_UNDEFINED,
+                                                            .loadOp             = VK_ATTACHMENT_LOAD_OP_CLEAR,
+                                                            .storeOp            = VK_ATTACHMENT_STORE_OP_DONT_CARE,
+                                                            .clearValue         = clearValues[1] };
+
+        const VkRenderingInfo renderingInfo = { .sType                = VK_STRUCTURE_TYPE_RENDERING_INFO,
+                                                .pNext                = nullptr,
+                                                .flags                = VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS == contents
+                                                                            ? static_cast<VkRenderingFlags>(VK_RENDERING_CONTENTS_SECONDARY_COMMAND_BUFFERS_BIT)
+                                                                            : VkRenderingFlags {},
+                                                .renderArea           = { .offset = { 0, 0 }, .extent = m_swapChainExtent },
+                                                .layerCount           = 1,
+                                                .viewMask             = 0,
+                                                .colorAttachmentCount = 1,
+                                                .pColorAttachments    = &colorAttachment,
+                                                .pDepthAttachment     = UsesDepthBuffer() ? &depthAttachment : nullptr,
+                                                .pStencilAttachment   = nullptr };
+
+        vkCmdBeginRendering(commandBuffer, &renderingInfo);
+        return;
+    }
+
     // clang-format off
-    const VkClearValue          clearColor     = { { { 0.0F, 0.0F, 0.0F, 1.0F } } };
     const VkRenderPassBeginInfo renderPassInfo = {
         .sType           = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO,
         .pNext           = nullptr,
@@ -848,12 +2452,32 @@ void HelloTriangleApplication::RecordCommandBuffer(VkCommandBuffer commandBuffer
             .offset      = { 0, 0 },
             .extent      = m_swapChainExtent
         },
-        .clearValueCount = 1,
-        .pClearValues    = &clearColor };
+        .clearValueCount = UsesDepthBuffer() ? 2U : 1U,
+        .pClearValues    = clearValues.data() };
     // clang-format on
 
-    vkCmdBeginRenderPass(commandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
-    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_graphicsPipeline);
+    vkCmdBeginRenderPass(commandBuffer, &renderPassInfo, contents);
+}
+
+void HelloTriangleApplication::EndRenderPass(VkCommandBuffer commandBuffer, uint32_t imageIndex) {
+    if (!m_dynamicRendering) {
+        vkCmdEndRenderPass(commandBuffer);
+        return;
+    }
+
+    // Matches the render pass final layout and its implicit external dependency, presentation and readback synchronize through semaphores and fences.
+    vkCmdEndRendering(commandBuffer);
+    RecordImageBarrier(commandBuffer, m_swapChainImages[imageIndex], VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, FinalImageLayout(),
+                       VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT, VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT, VK_PIPELINE_STAGE_2_NONE, VK_ACCESS_2_NONE);
+}
+
+auto HelloTriangleApplication::FinalImageLayout() const -> VkImageLayout {
+    return m_settings.headless ? VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL : VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+}
+
+void HelloTriangleApplication::RecordDraws(VkCommandBuffer commandBuffer, uint32_t firstDraw, uint32_t drawCount) {
+    // Pipeline, dynamic state and bound buffers are not inherited by secondary command buffers, so they are set wherever draws are recorded.
+    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_framePipeline);
 
     // clang-format off
     const VkViewport viewport {
@@ -873,25 +2497,226 @@ void HelloTriangleApplication::RecordCommandBuffer(VkCommandBuffer commandBuffer
     vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
     // clang-format on
 
-    vkCmdDraw(commandBuffer, 3, 1, 0, 0);
-    vkCmdEndRenderPass(commandBuffer);
+    const VkDeviceSize vertexOffset = 0;
+    vkCmdBindVertexBuffers(commandBuffer, 0, 1, &m_vertexBuffer.buffer, &vertexOffset);
+    vkCmdBindIndexBuffer(commandBuffer, m_indexBuffer.buffer, 0, geometry::kIndexType);
+    vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_pipelineLayout, 0, 1, &m_descriptorSet, 0, nullptr);
 
-    if (const auto& result = vkEndCommandBuffer(commandBuffer) != VK_SUCCESS) {
-        throw std::runtime_error(std::format("{}::RecordCommandBuffer: Failed to end command buffer, error code: {}.", kClassName, result));
+    const geometry::View view       = geometry::MakeView(m_frameNumber, m_settings.viewZoom);
+    const auto           indexCount = static_cast<uint32_t>(geometry::kTriangleIndices.size());
+    vkCmdPushConstants(commandBuffer, m_pipelineLayout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(view), &view);
+
+    switch (m_settings.culling) {
+        case CullingMode::NONE:
+            // All instances go out in one instanced draw, their transforms and colors come from the instance storage buffer.
+            for (uint32_t i = 0; i < drawCount; i++) {
+                vkCmdDrawIndexed(commandBuffer, indexCount, m_settings.instanceCount, 0, 0, 0);
+            }
+            break;
+
+        case CullingMode::CPU:
+            // The draw items are the instances, every visible one gets a draw call of its own, selected through firstInstance.
+            for (uint32_t i = firstDraw; i < firstDraw + drawCount; i++) {
+                if (geometry::IsVisible(m_instances[i], view)) {
+                    vkCmdDrawIndexed(commandBuffer, indexCount, 1, 0, 0, i);
+                }
+            }
+            break;
+
+        case CullingMode::GPU:
+            // A single draw item, the draws themselves were written by RecordCulling.
+            if (0 != drawCount) {
+                vkCmdDrawIndexedIndirectCount(commandBuffer, m_drawCommandBuffer.buffer, 0, m_drawCountBuffer.buffer, 0, m_settings.instanceCount,
+                                              sizeof(VkDrawIndexedIndirectCommand));
+            }
+            break;
+    }
+}
+
+void HelloTriangleApplication::RecordCulling(VkCommandBuffer commandBuffer) {
+    // The draw buffers are shared by all frames in flight. The barriers order this frame's culling after the previous frame's draws,
+    // which costs a little overlap between frames but keeps the buffers as small as the instance count.
+    uint32_t cullRegion = { 0 };
+    if (nullptr != m_gpuTimer) {
+        cullRegion = m_gpuTimer->BeginRegion(commandBuffer, "culling");
+    }
+
+    RecordMemoryBarrier(commandBuffer, VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT, VK_ACCESS_2_NONE,
+                        VK_PIPELINE_STAGE_2_TRANSFER_BIT | VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_TRANSFER_WRITE_BIT | VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT);
+    vkCmdFillBuffer(commandBuffer, m_drawCountBuffer.buffer, 0, sizeof(uint32_t), 0);
+    RecordMemoryBarrier(commandBuffer, VK_PIPELINE_STAGE_2_TRANSFER_BIT, VK_ACCESS_2_TRANSFER_WRITE_BIT, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+                        VK_ACCESS_2_SHADER_STORAGE_READ_BIT | VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT);
+
+    const geometry::CullConstants constants = { .view        = geometry::MakeView(m_frameNumber, m_settings.viewZoom),
+                                                .objectCount = m_settings.instanceCount,
+                                                .indexCount  = static_cast<uint32_t>(geometry::kTriangleIndices.size()) };
+
+    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, m_cullPipeline);
+    vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, m_cullPipelineLayout, 0, 1, &m_cullDescriptorSet, 0, nullptr);
+    vkCmdPushConstants(commandBuffer, m_cullPipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(constants), &constants);
+    vkCmdDispatch(commandBuffer, (m_settings.instanceCount + kCullWorkgroupSize - 1) / kCullWorkgroupSize, 1, 1);
+
+    RecordMemoryBarrier(commandBuffer, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT, VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT,
+                        VK_ACCESS_2_INDIRECT_COMMAND_READ_BIT);
+
+    if (nullptr != m_gpuTimer) {
+        m_gpuTimer->EndRegion(commandBuffer, cullRegion);
+    }
+}
+
+void HelloTriangleApplication::RecordAnimation(VkCommandBuffer commandBuffer) {
+    // The instance buffer is shared by all frames in flight like the draw buffers of RecordCulling, so the first barrier orders this frame's
+    // writes after the previous frame's reads, the second hands the new instances to culling and the vertex shader on the same queue.
+    uint32_t animationRegion = { 0 };
+    if (nullptr != m_gpuTimer) {
+        animationRegion = m_gpuTimer->BeginRegion(commandBuffer, "animation");
+    }
+
+    RecordMemoryBarrier(commandBuffer, VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_NONE,
+                        VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT);
+
+    const geometry::AnimationConstants constants = geometry::MakeAnimationConstants(m_settings.instanceCount, m_settings.instanceScale, m_frameNumber);
+
+    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, m_animatePipeline);
+    vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, m_animatePipelineLayout, 0, 1, &m_descriptorSet, 0, nullptr);
+    vkCmdPushConstants(commandBuffer, m_animatePipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(constants), &constants);
+    vkCmdDispatch(commandBuffer, (m_settings.instanceCount + kAnimateWorkgroupSize - 1) / kAnimateWorkgroupSize, 1, 1);
+
+    RecordMemoryBarrier(commandBuffer, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT,
+                        VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_STORAGE_READ_BIT);
+
+    if (nullptr != m_gpuTimer) {
+        m_gpuTimer->EndRegion(commandBuffer, animationRegion);
+    }
+}
+
+auto HelloTriangleApplication::DrawItemCount() const -> uint32_t {
+    // The unit the draws are split in between recording threads.
+    switch (m_settings.culling) {
+        case CullingMode::CPU: return m_settings.instanceCount;
+        case CullingMode::GPU: return 1;
+        default:               return m_settings.drawCount;
     }
 }
 
+void HelloTriangleApplication::RecordMemoryBarrier(VkCommandBuffer commandBuffer, VkPipelineStageFlags2 srcStageMask, VkAccessFlags2 srcAccessMask,
+                                                   VkPipelineStageFlags2 dstStageMask, VkAccessFlags2 dstAccessMask) {
+    const VkMemoryBarrier2 barrier        = { .sType         = VK_STRUCTURE_TYPE_MEMORY_BARRIER_2,
+                                              .pNext         = nullptr,
+                                              .srcStageMask  = srcStageMask,
+                                              .srcAccessMask = srcAccessMask,
+                                              .dstStageMask  = dstStageMask,
+                                              .dstAccessMask = dstAccessMask };
+    const VkDependencyInfo dependencyInfo = { .sType                    = VK_STRUCTURE_TYPE_DEPENDENCY_INFO,
+                                              .pNext                    = nullptr,
+                                              .dependencyFlags          = {},
+                                              .memoryBarrierCount       = 1,
+                                              .pMemoryBarriers          = &barrier,
+                                              .bufferMemoryBarrierCount = 0,
+                                              .pBufferMemoryBarriers    = nullptr,
+                                              .imageMemoryBarrierCount  = 0,
+                                              .pImageMemoryBarriers     = nullptr };
+    vkCmdPipelineBarrier2(commandBuffer, &dependencyInfo);
+}
+
+void HelloTriangleApplication::RecordImageBarrier(VkCommandBuffer commandBuffer, VkImage image, VkImageLayout oldLayout, VkImageLayout newLayout,
+                                                  VkPipelineStageFlags2 srcStageMask, VkAccessFlags2 srcAccessMask, VkPipelineStageFlags2 dstStageMask,
+                                                  VkAccessFlags2 dstAccessMask, VkImageAspectFlags aspectMask) {
+    const VkImageMemoryBarrier2 barrier        = { .sType               = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2,
+                                                   .pNext               = nullptr,
+                                                   .srcStageMask        = srcStageMask,
+                                                   .srcAccessMask       = srcAccessMask,
+                                                   .dstStageMask        = dstStageMask,
+                                                   .dstAccessMask       = dstAccessMask,
+                                                   .oldLayout           = oldLayout,
+                                                   .newLayout           = newLayout,
+                                                   .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                                                   .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                                                   .image               = image,
+                                                   .subresourceRange    = { .aspectMask     = aspectMask,
+                                                                            .baseMipLevel   = 0,
+                                                                            .levelCount     = 1,
+                                                                            .baseArrayLayer = 0,
+                                                                            .layerCount     = 1 } };
+    const VkDependencyInfo      dependencyInfo = { .sType                    = VK_STRUCTURE_TYPE_DEPENDENCY_INFO,
+                                                   .pNext                    = nullptr,
+                                                   .dependencyFlags          = {},
+                                                   .memoryBarrierCount       = 0,
+                                                   .pMemoryBarriers          = nullptr,
+                                                   .bufferMemoryBarrierCount = 0,
+                                                   .pBufferMemoryBarriers    = nullptr,
+                                                   .imageMemoryBarrierCount  = 1,
+                                                   .pImageMemoryBarriers     = &barrier };
+    vkCmdPipelineBarrier2(commandBuffer, &dependencyInfo);
+}
+
+void HelloTriangleApplication::CreateGpuTimer() {
+    VT_TRACE_ZONE("CreateGpuTimer");
+
+    // A static command buffer is submitted from every frame slot, so it can't reset and write the queries of a single slot.
+    if (m_settings.staticScene) {
+        throw std::runtime_error(std::format("{}::CreateGpuTimer: GPU stats are not supported together with a static scene.", kClassName));
+    }
+
+    m_gpuTimer = std::make_unique<profiling::GpuTimer>(m_device, m_physicalDevice, FindQueueFamilies(m_physicalDevice).GetGraphicsFamilyValue(),
+                                                       static_cast<uint32_t>(m_frames.size()));
+}
+
+void HelloTriangleApplication::PrintGpuStats() const {
+    for (const auto& region : m_gpuTimer->GetRegionStats()) {
+        std::cout << std::format("{}::PrintGpuStats: GPU [{}] mean {:.3f} ms, max {:.3f} ms over {} frames.\n", kClassName, region.name, region.MeanMs(), region.maxMs,
+                                 region.samples);
+    }
+}
+
+void HelloTriangleApplication::CreateOverdrawCounter() {
+    VT_TRACE_ZONE("CreateOverdrawCounter");
+
+    // Like the GPU timer, a static command buffer can't reset and read the query of a single frame slot.
+    if (m_settings.staticScene) {
+        throw std::runtime_error(std::format("{}::CreateOverdrawCounter: Overdraw stats are not supported together with a static scene.", kClassName));
+    }
+
+    m_overdrawCounter = std::make_unique<profiling::OverdrawCounter>(m_device, static_cast<uint32_t>(m_frames.size()));
+}
+
 void HelloTriangleApplication::CreateSyncObjects() {
+    VT_TRACE_ZONE("CreateSyncObjects");
+
+    // A single timeline semaphore paces every frame slot, its value is the number of frames the GPU has finished.
+    VkSemaphoreTypeCreateInfo timelineInfo = {};
+    timelineInfo.sType                     = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO;
+    timelineInfo.semaphoreType             = VK_SEMAPHORE_TYPE_TIMELINE;
+    timelineInfo.initialValue              = m_frameNumber;
+
     // clang-format off
-    const VkSemaphoreCreateInfo semaphoreInfo = { .sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO, .pNext = nullptr, .flags = {} };
-    const VkFenceCreateInfo     fenceInfo     = { .sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO,     .pNext = nullptr, .flags = VK_FENCE_CREATE_SIGNALED_BIT };
+    const VkSemaphoreCreateInfo timelineSemaphoreInfo = { .sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO, .pNext = &timelineInfo, .flags = {} };
+    const VkSemaphoreCreateInfo semaphoreInfo         = { .sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO, .pNext = nullptr,       .flags = {} };
 
-    if (vkCreateSemaphore(m_device, &semaphoreInfo, nullptr, &m_imageAvailableSemaphore) != VK_SUCCESS ||
-        vkCreateSemaphore(m_device, &semaphoreInfo, nullptr, &m_renderFinishedSemaphore) != VK_SUCCESS ||
-        vkCreateFence(    m_device, &fenceInfo,     nullptr, &m_inFlightFence)           != VK_SUCCESS) {
-        throw std::runtime_error(std::format("{}::RecordCommandBuffer: Failed to create semaphores/fence!", kClassName));
+    if (vkCreateSemaphore(m_device, &timelineSemaphoreInfo, nullptr, &m_frameTimeline) != VK_SUCCESS) {
+        throw std::runtime_error(std::format("{}::CreateSyncObjects: Failed to create frame timeline semaphore!", kClassName));
+    }
+
+    // The swap chain only works with binary semaphores, which are only needed when there is something to acquire.
+    for (auto& frame : m_frames) {
+        if (!m_settings.headless && vkCreateSemaphore(m_device, &semaphoreInfo, nullptr, &frame.imageAvailableSemaphore) != VK_SUCCESS) {
+            throw std::runtime_error(std::format("{}::CreateSyncObjects: Failed to create frame semaphores!", kClassName));
+        }
     }
     // clang-format on
+
+    CreateRenderFinishedSemaphores();
+}
+
+void HelloTriangleApplication::CreateRenderFinishedSemaphores() {
+    const VkSemaphoreCreateInfo semaphoreInfo = { .sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO, .pNext = nullptr, .flags = {} };
+
+    m_renderFinishedSemaphores.resize(m_settings.headless ? 0 : m_swapChainImages.size());
+    for (auto& semaphore : m_renderFinishedSemaphores) {
+        if (vkCreateSemaphore(m_device, &semaphoreInfo, nullptr, &semaphore) != VK_SUCCESS) {
+            throw std::runtime_error(std::format("{}::CreateRenderFinishedSemaphores: Failed to create render finished semaphores!", kClassName));
+        }
+    }
 }
 
 void HelloTriangleApplication::CheckExtensionSupport(const std::vector<const char*>& extensions) {
@@ -917,6 +2742,41 @@ void HelloTriangleApplication::CheckExtensionSupport(const std::vector<const cha
     }
 }
 
+auto HelloTriangleApplication::CheckDeviceFeatureSupport(VkPhysicalDevice device) -> bool {
+    VkPhysicalDeviceProperties properties = {};
+    vkGetPhysicalDeviceProperties(device, &properties);
+
+    // The frame loop is built on vkQueueSubmit2 and timeline semaphores.
+    if (properties.apiVersion < VK_API_VERSION_1_3) {
+        return false;
+    }
+
+    VkPhysicalDeviceVulkan13Features features13 = {};
+    features13.sType                            = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_3_FEATURES;
+
+    VkPhysicalDeviceVulkan12Features features12 = {};
+    features12.sType                            = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+    features12.pNext                            = &features13;
+
+    VkPhysicalDeviceFeatures2 features = {};
+    features.sType                     = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+    features.pNext                     = &features12;
+    vkGetPhysicalDeviceFeatures2(device, &features);
+
+    // GPU culling draws with vkCmdDrawIndexedIndirectCount, which is optional even in Vulkan 1.2+.
+    if (CullingMode::GPU == m_settings.culling && VK_TRUE != features12.drawIndirectCount) {
+        return false;
+    }
+
+    // Overdraw stats count fragment shader invocations with a pipeline statistics query, see CreateDevice.
+    if (m_settings.overdrawStats && (VK_TRUE != features.features.pipelineStatisticsQuery ||
+                                     (0 != m_settings.recordThreads && VK_TRUE != features.features.inheritedQueries))) {
+        return false;
+    }
+
+    return VK_TRUE == features12.timelineSemaphore && VK_TRUE == features13.synchronization2;
+}
+
 auto HelloTriangleApplication::CheckDeviceExtensionSupport(VkPhysicalDevice device) -> bool {
     uint32_t extensionCount = { 0 };
     vkEnumerateDeviceExtensionProperties(device, nullptr, &extensionCount, nullptr);
@@ -924,7 +2784,8 @@ auto HelloTriangleApplication::CheckDeviceExtensionSupport(VkPhysicalDevice devi
     std::vector<VkExtensionProperties> availableExtensions(extensionCount);
     vkEnumerateDeviceExtensionProperties(device, nullptr, &extensionCount, availableExtensions.data());
 
-    std::set<std::string> requiredExtensions(m_deviceExtensions.begin(), m_deviceExtensions.end());
+    const auto            deviceExtensions = GetRequiredDeviceExtensions();
+    std::set<std::string> requiredExtensions(deviceExtensions.begin(), deviceExtensions.end());
     for (const auto& extension : availableExtensions) {
         requiredExtensions.erase(static_cast<const char*>(extension.extensionName));
     }
@@ -1,20 +1,135 @@
 #pragma once
 
+#include <chrono>
+#include <cstddef>
 #include <cstdlib>
+#include <deque>
 #include <memory>
 #include <optional>
+#include <span>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #define GLFW_INCLUDE_VULKAN
 #include <GLFW/glfw3.h>
 
+#include "device_allocator.hpp"
+#include "frame_capture.hpp"
+#include "geometry.hpp"
+#include "gpu_timer.hpp"
+#include "overdraw_counter.hpp"
+#include "pipeline_variants.hpp"
+#include "task_graph.hpp"
+#include "thread_pool.hpp"
+#include "trace.hpp"
+#include "uploader.hpp"
+#include "validation_log.hpp"
+#include "vulkan_context.hpp"
+
+namespace vt::test {
+struct ApplicationProbe;
+}  // namespace vt::test
+
 namespace vt::triangle {
 
 // NOLINTBEGIN(misc-include-cleaner)
 class HelloTriangleApplication {
   public:
-    HelloTriangleApplication()           = default;
+    // Where the per object visibility test runs. NONE draws every instance in one instanced draw call, CPU tests every instance
+    // and records a draw call per visible one, GPU tests them in a compute pass that writes the draws for vkCmdDrawIndexedIndirectCount.
+    enum class CullingMode : uint8_t { NONE, CPU, GPU };
+
+    // Trade-off between latency, frame rate, power and tearing, which selects the present mode and the swap chain image count, see CreateSwapchain.
+    enum class PresentPolicy : uint8_t { LOW_LATENCY, THROUGHPUT, POWER_SAVER, TEAR_ALLOWED };
+
+    // Vertex color source, selected by a specialization constant of triangle.vert, which makes every mode its own pipeline variant.
+    // MIXED multiplies the vertex color with the instance color, VERTEX and INSTANCE use only the one.
+    enum class ColorMode : uint8_t { MIXED, VERTEX, INSTANCE };
+
+    // Order of the instances in the instance buffer, and with that the order they are drawn in. With the depth buffer FRONT_TO_BACK lets the
+    // early depth test reject hidden fragments before they are shaded, BACK_TO_FRONT is the worst case for it and the order blending needs.
+    enum class DrawOrder : uint8_t { UNSORTED, FRONT_TO_BACK, BACK_TO_FRONT };
+
+    struct Settings {
+        // NOLINTBEGIN(misc-non-private-member-variables-in-classes)
+        uint32_t        framesInFlight   = 2;                           // Number of frames the CPU may record ahead of the GPU.
+        bool            headless         = false;                       // Render into device owned images, without GLFW, a surface or a swap chain.
+        bool            staticScene      = false;                       // Record one command buffer per swap chain image once and only re-submit it.
+        bool            dynamicRendering = true;                        // Render with vkCmdBeginRendering instead of a render pass and framebuffers, when the device supports it.
+        PresentPolicy   presentPolicy    = PresentPolicy::LOW_LATENCY;  // Present mode and swap chain image count, ignored in headless mode.
+        ColorMode       colorMode        = ColorMode::MIXED;            // Pipeline variant built during startup, drawn with while other variants compile.
+        uint32_t        colorModeCycle   = 0;                           // Switch to the next color mode every N frames, compiling its variant in the background, 0 never switches.
+        uint32_t        drawCount        = 1;                           // Number of draw calls recorded per frame.
+        uint32_t        instanceCount    = 1;                           // Instances per draw call, read from a storage buffer by the vertex shader.
+        float           instanceScale    = 1.0F;                        // Size of each instance relative to its grid cell, i.e. the pixels covered per triangle.
+        bool            blend            = false;                       // Enable alpha blending, which costs extra color attachment bandwidth.
+        bool            depthBuffer      = true;                        // Depth test the instances, which are opaque. Ignored with 'blend', which relies on the draw order alone.
+        DrawOrder       drawOrder        = DrawOrder::FRONT_TO_BACK;    // Sorted by instance depth once, when the instance buffer is created.
+        bool            overdrawStats    = false;                       // Count the shaded fragments per pixel with a pipeline statistics query and print them on exit.
+        bool            animateInstances = false;                       // Rebuild the instance buffer with a compute shader every frame, see animate.comp.
+        VkCullModeFlags cullMode         = VK_CULL_MODE_BACK_BIT;       // VK_CULL_MODE_FRONT_BIT culls every triangle, leaving only the geometry cost.
+        CullingMode     culling          = CullingMode::NONE;           // Frustum culling of the instances, which are drawn as individual objects.
+        float           viewZoom         = 1.0F;                        // Camera zoom, about 1/zoom^2 of the instance grid is on screen.
+        uint32_t        recordThreads    = 0;                           // Worker threads recording secondary command buffers, 0 records inline.
+        uint32_t        initThreads      = 3;                           // Worker threads running independent initialization steps, 0 runs them in order.
+        uint64_t        maxFrames        = 0;                           // Stop the main loop after this many frames, 0 means no limit.
+        bool            gpuStats         = false;                       // Time the frame on the GPU with timestamp queries and print the results on exit.
+        bool            transferQueue    = true;                        // Upload on a queue family without graphics when there is one, instead of the graphics queue.
+        uint32_t        uploadStreamKiB  = 0;                           // KiB uploaded every frame, to measure the upload path under load.
+
+        // Debug builds only. Validation messages below 'validationSeverity' aren't reported by the layer at all, the others are
+        // deduplicated by message id and rate limited before a logger thread formats and prints them.
+        VkDebugUtilsMessageSeverityFlagBitsEXT validationSeverity    = VK_DEBUG_UTILS_MESSAGE_SEVERITY_WARNING_BIT_EXT;
+        uint32_t                               validationRepeatLimit = 3;    // Times each validation message id is printed, 0 prints every repeat.
+        uint32_t                               validationRateLimit   = 100;  // Validation messages below error severity printed per second, 0 means no limit.
+
+        // Frame capture, enabled by 'capturePath'. Every frame is copied into one of 'captureBuffers' persistently mapped buffers and written
+        // by a writer thread, frames are dropped while all of them still wait for the writer.
+        capture::Format captureFormat  = capture::Format::PNG;
+        uint32_t        captureBuffers = 3;  // Readback buffers, i.e. how many frames the writer may fall behind before frames are dropped.
+
+        std::string pipelineCachePath = "vulkan-triangle.pipeline-cache";  // Persistent pipeline cache, empty disables it.
+        std::string tracePath         = {};                                 // Chrome trace written on exit and on SIGUSR1, empty disables tracing.
+        std::string shaderDirectory   = {};                                 // Load '<name>.spv' from here instead of the embedded SPIR-V, for shader development.
+        std::string capturePath       = {};                                 // Frames written here, see capture::FrameCapture::Config::path. Empty disables capture.
+        // NOLINTEND(misc-non-private-member-variables-in-classes)
+    };
+
+    // CPU time spent in each step of the last DrawFrame call.
+    struct FrameTimings {
+        // NOLINTBEGIN(misc-non-private-member-variables-in-classes)
+        std::chrono::nanoseconds frameWait = {};
+        std::chrono::nanoseconds upload    = {};  // Writing the frame's uploads into the staging ring and submitting them, without waiting for them.
+        std::chrono::nanoseconds acquire   = {};
+        std::chrono::nanoseconds record    = {};
+        std::chrono::nanoseconds submit    = {};
+        std::chrono::nanoseconds present   = {};
+        std::chrono::nanoseconds recreate  = {};  // Swap chain recreation, included in the acquire or present step it happened in.
+        std::chrono::nanoseconds total     = {};
+
+        // From the last PollEvents call, i.e. the newest input the frame could have seen, until vkQueuePresentKHR returned.
+        // Does not include the time the presentation engine holds the image before it is on screen.
+        std::chrono::nanoseconds inputToPresent = {};
+        // NOLINTEND(misc-non-private-member-variables-in-classes)
+    };
+
+    struct PipelineStats {
+        // NOLINTBEGIN(misc-non-private-member-variables-in-classes)
+        bool                     cacheWarm  = false;  // Whether the pipeline cache was seeded from disk.
+        std::chrono::nanoseconds createTime = {};     // Time spent in vkCreateGraphicsPipelines.
+        // NOLINTEND(misc-non-private-member-variables-in-classes)
+    };
+
+    static constexpr uint32_t kMaxFramesInFlight = 8;
+    static constexpr uint32_t kColorModeCount    = 3;
+
+    HelloTriangleApplication() = default;
+    explicit HelloTriangleApplication(const Settings& settings) : m_settings(settings) {}
+
+    // Renders with the instance, and optionally the device, of 'context', shared with the other renderers created with it.
+    // Without a context the renderer creates a private one during initialization.
+    HelloTriangleApplication(const Settings& settings, std::shared_ptr<VulkanContext> context) : m_settings(settings), m_context(std::move(context)) {}
     ~HelloTriangleApplication() noexcept = default;
 
     // Copy constructor and assignment operator.
@@ -26,17 +141,92 @@ class HelloTriangleApplication {
     auto operator=(const HelloTriangleApplication&& other) noexcept -> HelloTriangleApplication& = delete;
 
     void Run() {
-        InitWindow();
-        InitVulkan();
+        Initialize();
         MainLoop();
         Cleanup();
     }
 
+    // The individual steps of Run(), for drivers such as the benchmark that own the frame loop.
+    void Initialize() {
+        if (nullptr == m_context) {
+            m_context = std::make_shared<VulkanContext>(1, true);
+        }
+
+        if (!m_settings.tracePath.empty()) {
+            trace::SetEnabled(true);
+            trace::SetThreadName("main");
+            trace::InstallDumpSignalHandler();
+        }
+
+        if (!m_settings.headless) {
+            InitWindow();
+        }
+        InitVulkan();
+    }
+
+    void DrawFrame();
+    auto PollEvents() -> bool;
+    void WaitIdle() const;
+
+    // Ignored in headless mode, which has no window to resize.
+    void SetWindowSize(int32_t width, int32_t height) {
+        if (nullptr != m_window) {
+            glfwSetWindowSize(m_window, width, height);
+        }
+    }
+
+    void Cleanup();
+
+    [[nodiscard]] auto GetSettings() const -> const Settings& { return m_settings; }
+    [[nodiscard]] auto GetLastFrameTimings() const -> const FrameTimings& { return m_lastFrameTimings; }
+    [[nodiscard]] auto GetPipelineStats() const -> const PipelineStats& { return m_pipelineStats; }
+
+    // Color mode variants compiled in the background, and the frames drawn with the startup variant while the one they asked for wasn't ready yet.
+    [[nodiscard]] auto GetPipelineVariantStats() const -> pipelines::PipelineVariants::Stats { return m_pipelineVariants->GetStats(); }
+    [[nodiscard]] auto GetFallbackFrameCount() const -> uint64_t { return m_fallbackFrames; }
+
+    // When each initialization step ran and on which thread, see InitVulkan.
+    [[nodiscard]] auto GetStartupTimeline() const -> const std::vector<threading::TaskGraph::TaskTiming>& { return m_startupTimeline; }
+
+    // Whether frames are rendered with vkCmdBeginRendering, decided at device creation from 'Settings::dynamicRendering' and device support.
+    [[nodiscard]] auto UsesDynamicRendering() const -> bool { return m_dynamicRendering; }
+
+    // Whether the instances are depth tested, see 'Settings::depthBuffer'.
+    [[nodiscard]] auto UsesDepthBuffer() const -> bool { return m_settings.depthBuffer && !m_settings.blend; }
+
+    // The present mode and image count the current swap chain was created with, picked from 'Settings::presentPolicy' and what the surface supports.
+    [[nodiscard]] auto GetPresentMode() const -> VkPresentModeKHR { return m_presentMode; }
+    [[nodiscard]] auto GetSwapchainImageCount() const -> uint32_t { return static_cast<uint32_t>(m_swapChainImages.size()); }
+
+    // Frames submitted so far, and frames the GPU has finished according to the frame timeline semaphore.
+    // The difference is how far the GPU is behind the CPU.
+    [[nodiscard]] auto GetSubmittedFrameCount() const -> uint64_t { return m_frameNumber; }
+    [[nodiscard]] auto GetCompletedFrameCount() const -> uint64_t;
+
+    // Triangles submitted per frame before culling.
+    [[nodiscard]] auto GetTrianglesPerFrame() const -> uint64_t;
+
+    [[nodiscard]] auto GetMemoryStats() const -> memory::DeviceAllocator::Stats { return m_allocator->GetStats(); }
+    [[nodiscard]] auto GetUploadStats() const -> memory::Uploader::Stats { return m_uploader->GetStats(); }
+
+    // Frame capture counters once the writer has caught up with every captured frame, all zero without 'Settings::capturePath'.
+    [[nodiscard]] auto GetCaptureStats() const -> capture::FrameCapture::Stats;
+
+    // GPU time per named region, a few frames behind the CPU. Empty unless 'Settings::gpuStats' is enabled.
+    [[nodiscard]] auto GetGpuStats() const -> std::vector<profiling::GpuTimer::RegionStats>;
+
+    // Fragment shader invocations per rendered pixel, a few frames behind the CPU. All zero unless 'Settings::overdrawStats' is enabled.
+    [[nodiscard]] auto GetOverdrawStats() const -> profiling::OverdrawCounter::Stats;
+
   private:
+    // Drives the private steps of a frame one at a time for the micro-benchmarks in test/.
+    friend struct test::ApplicationProbe;
+
     struct QueueFamilyIndices {
         // NOLINTBEGIN(misc-non-private-member-variables-in-classes)
         std::optional<uint32_t> graphicsFamily;
         std::optional<uint32_t> presentFamily;
+        std::optional<uint32_t> transferFamily;  // Only set for a family without graphics support.
         // NOLINTEND(misc-non-private-member-variables-in-classes)
 
         [[nodiscard]] auto IsComplete() const -> bool { return graphicsFamily.has_value() && presentFamily.has_value(); }
@@ -56,6 +246,9 @@ class HelloTriangleApplication {
 
             return presentFamily.value();
         }
+
+        // Falls back to the graphics family, which supports transfers as well.
+        [[nodiscard]] auto GetTransferFamilyValue() -> uint32_t { return transferFamily.has_value() ? transferFamily.value() : GetGraphicsFamilyValue(); }
     };
 
     struct SwapChainSupportDetails {
@@ -66,14 +259,45 @@ class HelloTriangleApplication {
         // NOLINTEND(misc-non-private-member-variables-in-classes)
     };
 
+    // Resources owned by a single frame in flight, indexed by 'm_frameNumber % framesInFlight'.
+    struct FrameData {
+        // NOLINTBEGIN(misc-non-private-member-variables-in-classes)
+        VkCommandBuffer commandBuffer           = VK_NULL_HANDLE;
+        VkCommandBuffer acquireCommandBuffer    = VK_NULL_HANDLE;  // Takes ownership of the uploads on the graphics queue, see QueueUploadAcquire.
+        VkCommandBuffer captureCommandBuffer    = VK_NULL_HANDLE;  // Copies the rendered image into a readback buffer, see QueueFrameCapture.
+        VkSemaphore     imageAvailableSemaphore = VK_NULL_HANDLE;
+
+        // One command pool and secondary command buffer per recording thread.
+        std::vector<VkCommandPool>   workerCommandPools;
+        std::vector<VkCommandBuffer> secondaryCommandBuffers;
+        // NOLINTEND(misc-non-private-member-variables-in-classes)
+    };
+
+    // Swap chain objects replaced by a recreation. They may still be referenced by frames in flight,
+    // so they are destroyed once every frame submitted before 'retiredAtFrame' has finished.
+    struct RetiredSwapchain {
+        // NOLINTBEGIN(misc-non-private-member-variables-in-classes)
+        uint64_t                       retiredAtFrame = 0;
+        VkSwapchainKHR                 swapChain      = VK_NULL_HANDLE;
+        std::vector<VkImageView>       imageViews;
+        std::vector<VkFramebuffer>     framebuffers;
+        std::vector<VkSemaphore>       renderFinishedSemaphores;
+        std::vector<VkCommandBuffer>   staticCommandBuffers;
+        memory::DeviceAllocator::Image depthImage;
+        VkImageView                    depthImageView = VK_NULL_HANDLE;
+        // NOLINTEND(misc-non-private-member-variables-in-classes)
+    };
+
     enum DeviceSuitabilityScore : uint16_t { LOW = 125, LOW_MEDIUM = 250, MEDIUM = 500, MEDIUM_HIGH = 750, HIGH = 1000 };
 
     const std::string         kClassName = "HelloTriangleApplication";  // NOLINT(readability-identifier-naming)
     static constexpr uint32_t kWidth     = 800;
     static constexpr uint32_t kHeight    = 600;
 
+    static constexpr uint32_t kCullWorkgroupSize    = 64;  // local_size_x of cull.comp.
+    static constexpr uint32_t kAnimateWorkgroupSize = 64;  // local_size_x of animate.comp.
+
     const std::vector<const char*> m_validationLayers = { "VK_LAYER_KHRONOS_validation" };
-    const std::vector<const char*> m_deviceExtensions = { VK_KHR_SWAPCHAIN_EXTENSION_NAME };
 
 #ifdef NDEBUG
     static constexpr bool kEnableValidationLayers = false;
@@ -81,68 +305,179 @@ class HelloTriangleApplication {
     static constexpr bool kEnableValidationLayers = true;
 #endif
 
-    VkSemaphore m_imageAvailableSemaphore = {};
-    VkSemaphore m_renderFinishedSemaphore = {};
-    VkFence     m_inFlightFence           = {};
+    Settings m_settings = {};
+
+    std::vector<FrameData>       m_frames;
+    std::vector<VkSemaphore>     m_renderFinishedSemaphores;  // One per swap chain image, the present engine owns it until the image is re-acquired.
+    std::vector<VkCommandBuffer> m_staticCommandBuffers;      // One per swap chain image, only used in static scene mode.
+    uint64_t                     m_frameNumber   = 0;
+    VkSemaphore                  m_frameTimeline = VK_NULL_HANDLE;  // Signaled with 'frame number + 1' by the submit of each frame.
+    FrameTimings                 m_lastFrameTimings;
+
+    // Work for the current frame, sent in a single batched vkQueueSubmit2 by SubmitFrame.
+    std::vector<VkCommandBufferSubmitInfo> m_pendingCommandBuffers;
+    std::vector<VkSemaphoreSubmitInfo>     m_pendingWaitSemaphores;
+
+    std::unique_ptr<threading::ThreadPool>      m_recordThreadPool;
+    std::unique_ptr<profiling::GpuTimer>        m_gpuTimer;
+    std::unique_ptr<profiling::OverdrawCounter> m_overdrawCounter;  // Only used with 'Settings::overdrawStats'.
+    std::unique_ptr<capture::FrameCapture>      m_frameCapture;     // Only used with 'Settings::capturePath'.
+
+    std::deque<RetiredSwapchain>          m_retiredSwapchains;
+    bool                                  m_framebufferResized = false;
+    VkPresentModeKHR                      m_presentMode        = VK_PRESENT_MODE_FIFO_KHR;
+    std::chrono::steady_clock::time_point m_lastPollTime;  // Start of the last PollEvents call.
+
+    std::shared_ptr<VulkanContext> m_context;             // Owns the instance, and the device unless m_ownsDevice.
+    bool                           m_ownsDevice = false;  // Whether the device is this renderer's own rather than the context's shared one.
+    uint32_t                       m_queueIndex = 0;      // Index of this renderer's queues within their families, see CreateLogicalDevice.
 
     VkInstance               m_instance       = VK_NULL_HANDLE;
-    VkDebugUtilsMessengerEXT m_debugMessenger = VK_NULL_HANDLE;
     GLFWwindow*              m_window         = VK_NULL_HANDLE;
     VkPhysicalDevice         m_physicalDevice = VK_NULL_HANDLE;
     VkDevice                 m_device         = VK_NULL_HANDLE;
     VkQueue                  m_graphicsQueue  = VK_NULL_HANDLE;
     VkQueue                  m_presentQueue   = VK_NULL_HANDLE;
+    VkQueue                  m_transferQueue  = VK_NULL_HANDLE;
     VkSurfaceKHR             m_surface        = VK_NULL_HANDLE;
     VkSwapchainKHR           m_swapChain      = VK_NULL_HANDLE;
 
-    std::vector<VkImage>       m_swapChainImages;
+    std::unique_ptr<memory::DeviceAllocator>         m_allocator;
+    memory::DeviceAllocator::Buffer                  m_vertexBuffer;
+    memory::DeviceAllocator::Buffer                  m_indexBuffer;
+    memory::DeviceAllocator::Buffer                  m_instanceBuffer;
+    memory::DeviceAllocator::Buffer                  m_drawCommandBuffer;          // Only used with GPU culling, written by cull.comp.
+    memory::DeviceAllocator::Buffer                  m_drawCountBuffer;            // Only used with GPU culling, written by cull.comp.
+    std::vector<geometry::InstanceData>              m_instances;                  // CPU copy of the instance buffer, only used with CPU culling.
+    std::unique_ptr<memory::Uploader>                m_uploader;
+    memory::DeviceAllocator::Buffer                  m_streamBuffer;               // Only used with an upload stream, one region per frame slot.
+    std::vector<std::byte>                           m_streamData;
+    std::vector<memory::DeviceAllocator::Allocation> m_offscreenImageAllocations;  // Only used in headless mode.
+
+    std::vector<VkImage>       m_swapChainImages;  // Swap chain images, or the offscreen render targets in headless mode.
     std::vector<VkImageView>   m_swapChainImageViews;
-    std::vector<VkFramebuffer> m_swapChainFramebuffers;
-
-    VkFormat         m_swapChainImageFormat = {};
-    VkExtent2D       m_swapChainExtent      = {};
-    VkRenderPass     m_renderPass           = {};
-    VkPipelineLayout m_pipelineLayout       = {};
-    VkPipeline       m_graphicsPipeline     = {};
-    VkCommandPool    m_commandPool          = {};
-    VkCommandBuffer  m_commandBuffer        = {};
+    std::vector<VkFramebuffer> m_swapChainFramebuffers;  // Empty with dynamic rendering.
+
+    // Only used with a depth buffer. A single one is shared by every frame, the render pass orders the depth writes of consecutive frames.
+    memory::DeviceAllocator::Image m_depthImage;
+    VkImageView                    m_depthImageView = VK_NULL_HANDLE;
+    VkFormat                       m_depthFormat    = VK_FORMAT_UNDEFINED;  // Picked with the logical device, see ChooseDepthFormat.
+
+    VkFormat              m_swapChainImageFormat = {};
+    VkExtent2D            m_swapChainExtent      = {};
+    VkRenderPass          m_renderPass           = {};  // VK_NULL_HANDLE with dynamic rendering.
+    VkDescriptorSetLayout m_descriptorSetLayout  = {};
+    VkDescriptorPool      m_descriptorPool       = {};
+    VkDescriptorSet       m_descriptorSet        = {};
+    VkPipelineLayout      m_pipelineLayout       = {};
+    VkPipeline            m_graphicsPipeline     = {};  // The 'Settings::colorMode' variant, built synchronously during startup.
+    VkPipeline            m_framePipeline        = {};  // The variant the current frame is recorded with, see SelectGraphicsPipeline.
+
+    std::unique_ptr<pipelines::PipelineVariants> m_pipelineVariants;    // Indexed by ColorMode, compiled on first use.
+    uint64_t                                     m_fallbackFrames = 0;  // Frames drawn with m_graphicsPipeline while their variant compiled.
+
+    // Only used with GPU culling.
+    VkDescriptorSetLayout m_cullDescriptorSetLayout = {};
+    VkDescriptorSet       m_cullDescriptorSet       = {};
+    VkPipelineLayout      m_cullPipelineLayout      = {};
+    VkPipeline            m_cullPipeline            = {};
+
+    // Only used with 'animateInstances', animate.comp writes the instance buffer through m_descriptorSet.
+    VkPipelineLayout m_animatePipelineLayout = {};
+    VkPipeline       m_animatePipeline       = {};
+
+    VkPipelineCache       m_pipelineCache        = {};
+    VkCommandPool         m_commandPool          = {};
+    PipelineStats         m_pipelineStats        = {};
+    bool                  m_dynamicRendering     = false;
+
+    std::vector<threading::TaskGraph::TaskTiming> m_startupTimeline;
 
     void InitWindow();
+    static void FramebufferResizeCallback(GLFWwindow* window, int width, int height);
     void InitVulkan();
+    void PrintStartupTimeline(std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point end) const;
     void MainLoop();
-    void DrawFrame();
-    void Cleanup();
 
     void CreateInstance();
+    auto CreateVulkanInstance() -> VulkanContext::Instance;
     auto GetRequiredExtensions() -> std::vector<const char*>;
+    auto GetRequiredDeviceExtensions() const -> std::vector<const char*>;
 
-    void SetupDebugMessenger();
-    auto PopulateDebugMessengerCreateInfo() -> std::shared_ptr<VkDebugUtilsMessengerCreateInfoEXT>;
+    void SetupDebugMessenger(VulkanContext::Instance& instance);
+    auto PopulateDebugMessengerCreateInfo(validation::MessageLog* log) -> std::shared_ptr<VkDebugUtilsMessengerCreateInfoEXT>;
 
     void CreateSurface();
     void PickPhysicalDevice();
     void CreateLogicalDevice();
+    auto CreateDevice(uint32_t queueCount) -> VulkanContext::Device;
 
     auto RateDeviceSuitability(VkPhysicalDevice device) -> uint32_t;
     auto FindQueueFamilies(VkPhysicalDevice device) -> QueueFamilyIndices;
     auto QuerySwapChainSupport(VkPhysicalDevice device) -> SwapChainSupportDetails;
 
     void CreateSwapchain();
+    void RecreateSwapchain();
+    void ReleaseRetiredSwapchains(bool force);
+    void CreateOffscreenTargets();
     void CreateImageViews();
+    void CreateDepthResources();
+    auto ChooseDepthFormat() const -> VkFormat;
     auto ChooseSwapExtent(const VkSurfaceCapabilitiesKHR& capabilities) -> VkExtent2D;
+    auto ChooseSwapImageCount(const VkSurfaceCapabilitiesKHR& capabilities) const -> uint32_t;
+    static auto PresentModePreferences(PresentPolicy policy) -> std::span<const VkPresentModeKHR>;
 
     void CreateRenderPass();
+    void CreatePipelineCache();
+    void SavePipelineCache();
     void CreateGraphicsPipeline();
-    auto CreateShaderModule(const std::vector<char>& code) -> VkShaderModule;
+    auto BuildGraphicsPipeline(ColorMode colorMode, VkFormat colorFormat) -> VkPipeline;
+    auto SelectGraphicsPipeline() -> VkPipeline;
+    void CreateCullPipeline();
+    void CreateAnimatePipeline();
+    auto CreateShaderModule(std::string_view name, std::span<const uint32_t> embeddedCode) -> VkShaderModule;
 
     void CreateFramebuffers();
     void CreateCommandPool();
+    void CreateGeometryBuffers();
+    void CreateDescriptorSetLayout();
+    void CreateDescriptorSet();
+    void CreateUploader();
     void CreateCommandBuffers();
-    void RecordCommandBuffer(VkCommandBuffer commandBuffer, uint32_t imageIndex);
-
+    void RecordCommandBuffer(VkCommandBuffer commandBuffer, uint32_t imageIndex, VkCommandBufferUsageFlags usageFlags = {});
+    void RecordStaticCommandBuffers();
+    void RecordCommandBufferParallel(FrameData& frame, uint32_t imageIndex);
+    void RecordSecondaryCommandBuffer(VkCommandPool commandPool, VkCommandBuffer commandBuffer, uint32_t imageIndex, uint32_t firstDraw, uint32_t drawCount);
+    void BeginRenderPass(VkCommandBuffer commandBuffer, uint32_t imageIndex, VkSubpassContents contents);
+    void EndRenderPass(VkCommandBuffer commandBuffer, uint32_t imageIndex);
+    auto FinalImageLayout() const -> VkImageLayout;
+    void RecordDraws(VkCommandBuffer commandBuffer, uint32_t firstDraw, uint32_t drawCount);
+    void RecordCulling(VkCommandBuffer commandBuffer);
+    void RecordAnimation(VkCommandBuffer commandBuffer);
+    auto DrawItemCount() const -> uint32_t;
+    static void RecordMemoryBarrier(VkCommandBuffer commandBuffer, VkPipelineStageFlags2 srcStageMask, VkAccessFlags2 srcAccessMask,
+                                    VkPipelineStageFlags2 dstStageMask, VkAccessFlags2 dstAccessMask);
+    static void RecordImageBarrier(VkCommandBuffer commandBuffer, VkImage image, VkImageLayout oldLayout, VkImageLayout newLayout, VkPipelineStageFlags2 srcStageMask,
+                                   VkAccessFlags2 srcAccessMask, VkPipelineStageFlags2 dstStageMask, VkAccessFlags2 dstAccessMask,
+                                   VkImageAspectFlags aspectMask = VK_IMAGE_ASPECT_COLOR_BIT);
+
+    void CreateGpuTimer();
+    void PrintGpuStats() const;
+    void CreateOverdrawCounter();
     void CreateSyncObjects();
+    void WaitForFrameSlot();
+    void QueueUploadAcquire(FrameData& frame);
+    void CreateFrameCapture();
+    void QueueFrameCapture(FrameData& frame, uint32_t imageIndex);
+    void QueueCommandBuffer(VkCommandBuffer commandBuffer);
+    void QueueSemaphoreWait(VkSemaphore semaphore, uint64_t value, VkPipelineStageFlags2 stageMask);
+    void SubmitFrame(VkSemaphore renderFinishedSemaphore);
+    void CreateRenderFinishedSemaphores();
+    auto CurrentFrameIndex() const -> uint32_t { return static_cast<uint32_t>(m_frameNumber % m_frames.size()); }
+    auto CurrentFrame() -> FrameData& { return m_frames[CurrentFrameIndex()]; }
     void CheckExtensionSupport(const std::vector<const char*>& extension);
     auto CheckDeviceExtensionSupport(VkPhysicalDevice device) -> bool;
+    auto CheckDeviceFeatureSupport(VkPhysicalDevice device) -> bool;
     void CheckValidationLayerSupport();
 };
 // NOLINTEND(misc-include-cleaner)
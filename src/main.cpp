@@ -1,16 +1,121 @@
+#include <cstdint>
 #include <cstdlib>
 #include <exception>
+#include <format>
 #include <iostream>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
 
+#include "command_line.hpp"
 #include "hello_triangle_application.hpp"
+#include "vulkan_context.hpp"
 
-auto main() -> int {
-    vt::triangle::HelloTriangleApplication app;
+namespace {
 
-    std::cout << "Hello Vulkan Triangle!\n";
+struct Settings {
+    // NOLINTBEGIN(misc-non-private-member-variables-in-classes)
+    vt::triangle::HelloTriangleApplication::Settings app         = {};
+    uint32_t                                         renderers   = 1;      // Independent renderers, each on its own thread.
+    bool                                             shareDevice = false;  // Whether the renderers share one VkDevice rather than one each.
+    // NOLINTEND(misc-non-private-member-variables-in-classes)
+};
 
+auto ParseArguments(std::span<char*> args) -> Settings {
+    Settings settings = {};
+
+    for (size_t i = 1; i < args.size(); i++) {
+        const std::string_view arg = args[i];
+
+        if (vt::cli::ParseSettingsOption(args, i, settings.app)) {
+            continue;
+        }
+
+        if (arg == "--renderers") {
+            settings.renderers = static_cast<uint32_t>(std::stoul(vt::cli::NextValue(args, i)));
+        } else if (arg == "--share-device") {
+            settings.shareDevice = true;
+        } else {
+            throw std::invalid_argument(std::format("Unknown option [{}].", arg));
+        }
+    }
+
+    if (0 == settings.renderers) {
+        throw std::invalid_argument("At least one renderer is required.");
+    }
+
+    // GLFW may only be used from the main thread, so the renderers can't have windows of their own.
+    if (settings.renderers > 1 && !settings.app.headless) {
+        throw std::invalid_argument("More than one renderer requires --headless.");
+    }
+
+    if (settings.renderers > 1 && !settings.app.capturePath.empty()) {
+        throw std::invalid_argument("--capture supports a single renderer only.");
+    }
+
+    // The trace zones are collected process wide, and every renderer would write all of them to the same file when it exits.
+    if (settings.renderers > 1 && !settings.app.tracePath.empty()) {
+        throw std::invalid_argument("--trace supports a single renderer only.");
+    }
+
+    return settings;
+}
+
+// Runs every renderer on a thread of its own, sharing the instance and with 'shareDevice' the device. Rethrows the first failure once all have finished.
+void RunRenderers(const Settings& settings) {
+    const auto context = std::make_shared<vt::triangle::VulkanContext>(settings.renderers, settings.shareDevice);
+
+    std::mutex         errorMutex;
+    std::exception_ptr firstError = nullptr;
+
+    std::vector<std::thread> threads = {};
+    threads.reserve(settings.renderers);
+    for (uint32_t i = 0; i < settings.renderers; i++) {
+        threads.emplace_back([&settings, &context, &errorMutex, &firstError]() {
+            try {
+                vt::triangle::HelloTriangleApplication app(settings.app, context);
+                app.Run();
+            } catch (...) {
+                const std::scoped_lock lock(errorMutex);
+                if (nullptr == firstError) {
+                    firstError = std::current_exception();
+                }
+            }
+        });
+    }
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    if (nullptr != firstError) {
+        std::rethrow_exception(firstError);
+    }
+}
+
+}  // namespace
+
+auto main(int argc, char* argv[]) -> int {
     try {
-        app.Run();
+        const Settings settings = ParseArguments({ argv, static_cast<size_t>(argc) });
+
+        // Captured frames written to stdout must not be interleaved with the log, which goes to stderr instead.
+        if (settings.app.capturePath == "-") {
+            std::cout.rdbuf(std::cerr.rdbuf());
+        }
+        std::cout << "Hello Vulkan Triangle!\n";
+
+        if (1 == settings.renderers) {
+            vt::triangle::HelloTriangleApplication app(settings.app);
+            app.Run();
+        } else {
+            RunRenderers(settings);
+        }
     } catch (const std::exception& e) {
         std::cerr << e.what() << "\n";
         return EXIT_FAILURE;
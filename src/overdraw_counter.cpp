@@ -0,0 +1,71 @@
+#include "overdraw_counter.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <format>
+#include <stdexcept>
+
+namespace vt::profiling {
+
+OverdrawCounter::OverdrawCounter(VkDevice device, uint32_t slotCount) : m_device(device), m_slotPixels(slotCount, 0) {
+    const VkQueryPoolCreateInfo createInfo = { .sType              = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO,
+                                               .pNext              = nullptr,
+                                               .flags              = {},
+                                               .queryType          = VK_QUERY_TYPE_PIPELINE_STATISTICS,
+                                               .queryCount         = slotCount,
+                                               .pipelineStatistics = VK_QUERY_PIPELINE_STATISTIC_FRAGMENT_SHADER_INVOCATIONS_BIT };
+
+    if (const auto& result = vkCreateQueryPool(m_device, &createInfo, nullptr, &m_queryPool) != VK_SUCCESS) {
+        throw std::runtime_error(std::format("OverdrawCounter::OverdrawCounter: Failed to create pipeline statistics query pool, error code: {}.", result));
+    }
+}
+
+OverdrawCounter::~OverdrawCounter() noexcept {
+    vkDestroyQueryPool(m_device, m_queryPool, nullptr);
+}
+
+void OverdrawCounter::BeginFrame(VkCommandBuffer commandBuffer, uint32_t slot, uint64_t pixelCount) {
+    CollectResult(slot);
+
+    m_currentSlot      = slot;
+    m_slotPixels[slot] = pixelCount;
+    vkCmdResetQueryPool(commandBuffer, m_queryPool, slot, 1);
+}
+
+void OverdrawCounter::Begin(VkCommandBuffer commandBuffer) {
+    vkCmdBeginQuery(commandBuffer, m_queryPool, m_currentSlot, {});
+}
+
+void OverdrawCounter::End(VkCommandBuffer commandBuffer) {
+    vkCmdEndQuery(commandBuffer, m_queryPool, m_currentSlot);
+}
+
+void OverdrawCounter::CollectResult(uint32_t slot) {
+    const uint64_t pixelCount = m_slotPixels[slot];
+    if (0 == pixelCount) {
+        return;
+    }
+
+    // A { value, availability } pair, without VK_QUERY_RESULT_WAIT_BIT an unavailable result is skipped rather than waited on.
+    std::array<uint64_t, 2> results = {};
+    const VkResult          result  = vkGetQueryPoolResults(m_device, m_queryPool, slot, 1, sizeof(results), results.data(), sizeof(results),
+                                                            VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WITH_AVAILABILITY_BIT);
+
+    if (VK_SUCCESS != result && VK_NOT_READY != result) {
+        throw std::runtime_error(std::format("OverdrawCounter::CollectResult: Failed to read pipeline statistics, error code: {}.", static_cast<int32_t>(result)));
+    }
+
+    if (0 == results[1]) {
+        return;
+    }
+
+    const double overdraw = static_cast<double>(results[0]) / static_cast<double>(pixelCount);
+
+    m_stats.frames++;
+    m_stats.totalInvocations += results[0];
+    m_stats.totalOverdraw    += overdraw;
+    m_stats.maxOverdraw       = std::max(m_stats.maxOverdraw, overdraw);
+}
+
+}  // namespace vt::profiling
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include <cstdint>
+#include <vector>
+
+namespace vt::profiling {
+
+// Counts the fragment shader invocations of a frame's render pass with a pipeline statistics query, one query per frame slot,
+// and relates them to the pixels rendered: an overdraw of 1 shades every pixel once, anything above is spent on hidden fragments.
+// Results are collected the next time a slot is recorded, like GpuTimer, so reading never stalls.
+//
+// Note: Implementations may count helper invocations and may not count fragments killed by early depth testing exactly, so the numbers
+// are meant for comparing configurations on one device, not devices.
+class OverdrawCounter {
+  public:
+    struct Stats {
+        // NOLINTBEGIN(misc-non-private-member-variables-in-classes)
+        uint64_t frames           = 0;
+        uint64_t totalInvocations = 0;
+        double   totalOverdraw    = 0.0;
+        double   maxOverdraw      = 0.0;
+        // NOLINTEND(misc-non-private-member-variables-in-classes)
+
+        [[nodiscard]] auto MeanInvocations() const -> double { return 0 == frames ? 0.0 : static_cast<double>(totalInvocations) / static_cast<double>(frames); }
+        [[nodiscard]] auto MeanOverdraw() const -> double { return 0 == frames ? 0.0 : totalOverdraw / static_cast<double>(frames); }
+    };
+
+    OverdrawCounter(VkDevice device, uint32_t slotCount);
+    ~OverdrawCounter() noexcept;
+
+    // Copy constructor and assignment operator.
+    OverdrawCounter(const OverdrawCounter& other)                    = delete;
+    auto operator=(const OverdrawCounter& other) -> OverdrawCounter& = delete;
+
+    // Move constructor and move assignment operator.
+    OverdrawCounter(OverdrawCounter&& other) noexcept                    = delete;
+    auto operator=(OverdrawCounter&& other) noexcept -> OverdrawCounter& = delete;
+
+    // Collects the count the slot recorded last time and resets its query. 'pixelCount' is the size of the render area this frame.
+    // Must be recorded outside of a render pass.
+    void BeginFrame(VkCommandBuffer commandBuffer, uint32_t slot, uint64_t pixelCount);
+
+    // Begin and End must be recorded outside of the render pass they count, into the same primary command buffer.
+    void Begin(VkCommandBuffer commandBuffer);
+    void End(VkCommandBuffer commandBuffer);
+
+    [[nodiscard]] auto GetStats() const -> const Stats& { return m_stats; }
+
+  private:
+    void CollectResult(uint32_t slot);
+
+    VkDevice    m_device      = VK_NULL_HANDLE;
+    VkQueryPool m_queryPool   = VK_NULL_HANDLE;
+    uint32_t    m_currentSlot = 0;
+
+    std::vector<uint64_t> m_slotPixels;  // Pixels rendered by the frame recorded into each slot, 0 while the slot has no query to collect.
+    Stats                 m_stats;
+};
+
+}  // namespace vt::profiling
@@ -0,0 +1,139 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <functional>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace vt::pipeline_cache {
+
+// Prefixed to the driver blob on disk. The driver validates its own header as well, but some drivers
+// are known to crash on foreign data, so anything not produced by this exact device and driver is discarded up front.
+struct FileHeader {
+    uint32_t magic                           = 0;
+    uint32_t headerVersion                   = 0;
+    uint32_t vendorID                        = 0;
+    uint32_t deviceID                        = 0;
+    uint32_t driverVersion                   = 0;
+    uint8_t  pipelineCacheUUID[VK_UUID_SIZE] = {};  // NOLINT(cppcoreguidelines-avoid-c-arrays, hicpp-avoid-c-arrays, modernize-avoid-c-arrays)
+    uint32_t reserved                        = 0;   // The padding in front of 'dataSize', explicit so that no uninitialized byte is written to disk.
+    uint64_t dataSize                        = 0;
+    uint64_t dataChecksum                    = 0;
+};
+
+// The header is written as raw bytes, which are only deterministic without implicit padding.
+static_assert(std::has_unique_object_representations_v<FileHeader>, "FileHeader must not contain implicit padding.");
+
+static constexpr uint32_t kMagic         = 0x43505456;  // "VTPC"
+static constexpr uint32_t kHeaderVersion = 1;
+
+// FNV-1a, only used to detect truncated or corrupted files.
+inline auto Checksum(std::span<const char> data) -> uint64_t {
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (const char byte : data) {
+        hash ^= static_cast<uint8_t>(byte);
+        hash *= 0x100000001b3ULL;
+    }
+
+    return hash;
+}
+
+inline auto MakeHeader(const VkPhysicalDeviceProperties& properties, std::span<const char> data) -> FileHeader {
+    FileHeader header    = {};
+    header.magic         = kMagic;
+    header.headerVersion = kHeaderVersion;
+    header.vendorID      = properties.vendorID;
+    header.deviceID      = properties.deviceID;
+    header.driverVersion = properties.driverVersion;
+    header.dataSize      = data.size();
+    header.dataChecksum  = Checksum(data);
+    std::memcpy(static_cast<uint8_t*>(header.pipelineCacheUUID), static_cast<const uint8_t*>(properties.pipelineCacheUUID), VK_UUID_SIZE);
+
+    return header;
+}
+
+// Returns the cached driver blob, or an empty vector if the file is missing, corrupt or was written by another device or driver.
+inline auto Load(const std::filesystem::path& path, const VkPhysicalDeviceProperties& properties) -> std::vector<char> {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        return {};
+    }
+
+    FileHeader header = {};
+    if (!file.read(reinterpret_cast<char*>(&header), sizeof(header))) {
+        return {};
+    }
+
+    const bool sameDevice = header.magic == kMagic && header.headerVersion == kHeaderVersion && header.vendorID == properties.vendorID &&
+                            header.deviceID == properties.deviceID && header.driverVersion == properties.driverVersion &&
+                            0 == std::memcmp(static_cast<const uint8_t*>(header.pipelineCacheUUID), static_cast<const uint8_t*>(properties.pipelineCacheUUID), VK_UUID_SIZE);
+
+    if (!sameDevice) {
+        return {};
+    }
+
+    // The size comes from the file as well, a truncated or corrupt file must not make it allocate more than the file holds.
+    std::error_code fileSizeError;
+    const uintmax_t fileSize = std::filesystem::file_size(path, fileSizeError);
+    if (fileSizeError || fileSize < sizeof(header) || header.dataSize > fileSize - sizeof(header)) {
+        return {};
+    }
+
+    std::vector<char> data(static_cast<size_t>(header.dataSize));
+    if (!file.read(data.data(), static_cast<std::streamsize>(data.size())) || Checksum(data) != header.dataChecksum) {
+        return {};
+    }
+
+    // The blob starts with a VkPipelineCacheHeaderVersionOne, which must agree with the file header.
+    VkPipelineCacheHeaderVersionOne driverHeader = {};
+    if (data.size() < sizeof(driverHeader)) {
+        return {};
+    }
+
+    std::memcpy(&driverHeader, data.data(), sizeof(driverHeader));
+    if (driverHeader.headerVersion != VK_PIPELINE_CACHE_HEADER_VERSION_ONE || driverHeader.vendorID != properties.vendorID ||
+        driverHeader.deviceID != properties.deviceID ||
+        0 != std::memcmp(static_cast<const uint8_t*>(driverHeader.pipelineCacheUUID), static_cast<const uint8_t*>(properties.pipelineCacheUUID), VK_UUID_SIZE)) {
+        return {};
+    }
+
+    return data;
+}
+
+// Writes to a temporary file next to 'path' and renames it into place, so a crash mid-write never leaves a partial cache behind.
+// The temporary file is named after the calling thread, so renderers saving the same cache concurrently don't write into each other's file.
+inline void Save(const std::filesystem::path& path, const VkPhysicalDeviceProperties& properties, std::span<const char> data) {
+    const FileHeader            header   = MakeHeader(properties, data);
+    const std::filesystem::path tempPath = std::filesystem::path(path) += std::format(".{:x}.tmp", std::hash<std::thread::id> {}(std::this_thread::get_id()));
+
+    {
+        std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            throw std::runtime_error(std::format("PipelineCache::Save: Failed to open file: [{}].", tempPath.string()));
+        }
+
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(data.data(), static_cast<std::streamsize>(data.size()));
+        file.flush();
+
+        if (!file) {
+            throw std::runtime_error(std::format("PipelineCache::Save: Failed to write file: [{}].", tempPath.string()));
+        }
+    }
+
+    std::filesystem::rename(tempPath, path);
+}
+
+}  // namespace vt::pipeline_cache
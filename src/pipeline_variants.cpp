@@ -0,0 +1,95 @@
+#include "pipeline_variants.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <exception>
+#include <format>
+#include <iostream>
+#include <mutex>
+#include <stop_token>
+#include <utility>
+
+#include "trace.hpp"
+
+namespace vt::pipelines {
+
+PipelineVariants::PipelineVariants(VkDevice device, uint32_t variantCount, BuildFunction build)
+    : m_device(device), m_build(std::move(build)), m_variants(variantCount), m_requested(variantCount),
+      m_thread([this](const std::stop_token& stopToken) { CompileLoop(stopToken); }) {}
+
+PipelineVariants::~PipelineVariants() noexcept {
+    m_thread.request_stop();
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+
+    for (auto& variant : m_variants) {
+        vkDestroyPipeline(m_device, variant.load(std::memory_order_acquire), nullptr);
+    }
+}
+
+auto PipelineVariants::Acquire(uint32_t variant) -> VkPipeline {
+    const VkPipeline pipeline = m_variants[variant].load(std::memory_order_acquire);
+    if (VK_NULL_HANDLE == pipeline) {
+        Request(variant);
+    }
+
+    return pipeline;
+}
+
+void PipelineVariants::Request(uint32_t variant) {
+    if (m_requested[variant].exchange(true, std::memory_order_relaxed)) {
+        return;
+    }
+
+    {
+        const std::scoped_lock lock(m_mutex);
+        m_queue.push_back(variant);
+    }
+    m_condition.notify_one();
+}
+
+auto PipelineVariants::GetStats() const -> Stats {
+    const std::scoped_lock lock(m_mutex);
+    return m_stats;
+}
+
+void PipelineVariants::CompileLoop(const std::stop_token& stopToken) {
+    trace::SetThreadName("pipeline compiler");
+
+    while (true) {
+        uint32_t variant = 0;
+        {
+            std::unique_lock lock(m_mutex);
+            if (!m_condition.wait(lock, stopToken, [this]() { return !m_queue.empty(); })) {
+                return;
+            }
+
+            variant = m_queue.front();
+            m_queue.pop_front();
+        }
+
+        VT_TRACE_ZONE("CompilePipelineVariant");
+        const auto start    = std::chrono::steady_clock::now();
+        VkPipeline pipeline = VK_NULL_HANDLE;
+        try {
+            pipeline = m_build(variant);
+        } catch (const std::exception& e) {
+            std::cerr << std::format("PipelineVariants::CompileLoop: Failed to build variant {}: {}\n", variant, e.what());
+        }
+        const auto compileTime = std::chrono::steady_clock::now() - start;
+
+        m_variants[variant].store(pipeline, std::memory_order_release);
+
+        const std::scoped_lock lock(m_mutex);
+        if (VK_NULL_HANDLE == pipeline) {
+            m_stats.failed++;
+        } else {
+            m_stats.compiled++;
+            m_stats.maxCompileTime = std::max(m_stats.maxCompileTime, std::chrono::duration_cast<std::chrono::nanoseconds>(compileTime));
+        }
+    }
+}
+
+}  // namespace vt::pipelines
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <stop_token>
+#include <thread>
+#include <vector>
+
+namespace vt::pipelines {
+
+// Compiles pipeline variants, e.g. the specialization constant permutations of one pipeline, on a background thread and
+// publishes each one atomically once it is built. The render loop never waits for a compile: until a variant is ready
+// Acquire returns VK_NULL_HANDLE and the caller draws with a fallback pipeline instead.
+class PipelineVariants {
+  public:
+    // Builds the given variant, called on the background thread only. An exception leaves the variant unavailable.
+    using BuildFunction = std::function<VkPipeline(uint32_t variant)>;
+
+    struct Stats {
+        // NOLINTBEGIN(misc-non-private-member-variables-in-classes)
+        uint32_t                 compiled       = 0;
+        uint32_t                 failed         = 0;
+        std::chrono::nanoseconds maxCompileTime = {};
+        // NOLINTEND(misc-non-private-member-variables-in-classes)
+    };
+
+    PipelineVariants(VkDevice device, uint32_t variantCount, BuildFunction build);
+
+    // Waits for the compile in progress, if any, and destroys every published variant. The device must not use them anymore.
+    ~PipelineVariants() noexcept;
+
+    // Copy constructor and assignment operator.
+    PipelineVariants(const PipelineVariants& other)                    = delete;
+    auto operator=(const PipelineVariants& other) -> PipelineVariants& = delete;
+
+    // Move constructor and move assignment operator.
+    PipelineVariants(PipelineVariants&& other) noexcept                    = delete;
+    auto operator=(PipelineVariants&& other) noexcept -> PipelineVariants& = delete;
+
+    // Returns the variant once it is ready, otherwise requests it and returns VK_NULL_HANDLE. Never blocks on a compile.
+    auto Acquire(uint32_t variant) -> VkPipeline;
+
+    // Queues a variant for compilation ahead of its first use. Requests after the first one are ignored.
+    void Request(uint32_t variant);
+
+    [[nodiscard]] auto GetStats() const -> Stats;
+
+  private:
+    void CompileLoop(const std::stop_token& stopToken);
+
+    VkDevice      m_device = VK_NULL_HANDLE;
+    BuildFunction m_build;
+
+    std::vector<std::atomic<VkPipeline>> m_variants;   // Published with release semantics once built.
+    std::vector<std::atomic<bool>>       m_requested;  // Set by the first request, so the render loop only locks once per variant.
+
+    mutable std::mutex          m_mutex;
+    std::condition_variable_any m_condition;
+    std::deque<uint32_t>        m_queue;
+    Stats                       m_stats;
+
+    std::jthread m_thread;  // Declared last, so that it is stopped and joined before the members it uses are destroyed.
+};
+
+}  // namespace vt::pipelines
@@ -1,36 +1,68 @@
+# The optimizer ships with the Vulkan SDK, without it glslc's own -O is used instead.
+find_program(SPIRV_OPT_EXECUTABLE spirv-opt HINTS "$ENV{VULKAN_SDK}/bin")
+
+set(EMBED_SPIRV_SCRIPT "${CMAKE_CURRENT_LIST_DIR}/EmbedSpirv.cmake")
+
 function(add_shaders TARGET_NAME)
   set(SHADER_SOURCE_FILES ${ARGN}) # The rest of arguments to this function will be assigned as shader source files
 
-  message(STATUS "Compiling shaders...")
-
   # Validate that source files have been passed.
   list(LENGTH SHADER_SOURCE_FILES FILE_COUNT)
   if(FILE_COUNT EQUAL 0)
+    message(FATAL_ERROR "add_shaders: No shader source files passed to [${TARGET_NAME}].")
+  endif()
+
+  if(SPIRV_OPT_EXECUTABLE)
+    message(STATUS "Optimizing shaders with ${SPIRV_OPT_EXECUTABLE}")
+  else()
+    message(STATUS "spirv-opt not found, optimizing shaders with glslc -O")
   endif()
 
-  set(SHADER_COMMANDS)
   set(SHADER_PRODUCTS)
+  set(SHADER_HEADER_DIR "${CMAKE_CURRENT_BINARY_DIR}/embedded_shaders")
 
+  # One command per shader, so that only the shaders whose source or includes changed are rebuilt.
   foreach(SHADER_SOURCE IN LISTS SHADER_SOURCE_FILES)
     cmake_path(ABSOLUTE_PATH SHADER_SOURCE NORMALIZE)
     cmake_path(GET SHADER_SOURCE FILENAME SHADER_NAME)
 
-    # Build command
-    list(APPEND SHADER_COMMANDS COMMAND)
-    list(APPEND SHADER_COMMANDS Vulkan::glslc)
-    list(APPEND SHADER_COMMANDS "${SHADER_SOURCE}")
-    list(APPEND SHADER_COMMANDS "-o")
-    list(APPEND SHADER_COMMANDS "${CMAKE_CURRENT_BINARY_DIR}/${SHADER_NAME}.spv")
+    set(SHADER_SPIRV  "${CMAKE_CURRENT_BINARY_DIR}/${SHADER_NAME}.spv")
+    set(SHADER_DEPS   "${CMAKE_CURRENT_BINARY_DIR}/${SHADER_NAME}.d")
+    set(SHADER_HEADER "${SHADER_HEADER_DIR}/${SHADER_NAME}.hpp")
+
+    if(SPIRV_OPT_EXECUTABLE)
+      set(SHADER_UNOPTIMIZED "${CMAKE_CURRENT_BINARY_DIR}/${SHADER_NAME}.unoptimized.spv")
+      set(SHADER_COMMANDS
+        COMMAND Vulkan::glslc -MD -MF "${SHADER_DEPS}" -MT "${SHADER_SPIRV}" "${SHADER_SOURCE}" -o "${SHADER_UNOPTIMIZED}"
+        COMMAND "${SPIRV_OPT_EXECUTABLE}" -O "${SHADER_UNOPTIMIZED}" -o "${SHADER_SPIRV}")
+    else()
+      set(SHADER_COMMANDS
+        COMMAND Vulkan::glslc -O -MD -MF "${SHADER_DEPS}" -MT "${SHADER_SPIRV}" "${SHADER_SOURCE}" -o "${SHADER_SPIRV}")
+    endif()
+
+    # The depfile written by glslc lists the #include'd files as well.
+    add_custom_command(
+      OUTPUT "${SHADER_SPIRV}"
+      ${SHADER_COMMANDS}
+      DEPENDS "${SHADER_SOURCE}"
+      DEPFILE "${SHADER_DEPS}"
+      COMMENT "Compiling shader ${SHADER_NAME}"
+      VERBATIM
+    )
 
-    # Add product
-    list(APPEND SHADER_PRODUCTS "${CMAKE_CURRENT_BINARY_DIR}/${SHADER_NAME}.spv")
+    add_custom_command(
+      OUTPUT "${SHADER_HEADER}"
+      COMMAND "${CMAKE_COMMAND}" -DINPUT=${SHADER_SPIRV} -DOUTPUT=${SHADER_HEADER} -DSHADER_NAME=${SHADER_NAME} -P "${EMBED_SPIRV_SCRIPT}"
+      DEPENDS "${SHADER_SPIRV}" "${EMBED_SPIRV_SCRIPT}"
+      COMMENT "Embedding shader ${SHADER_NAME}"
+      VERBATIM
+    )
 
+    list(APPEND SHADER_PRODUCTS "${SHADER_SPIRV}" "${SHADER_HEADER}")
   endforeach()
 
   add_custom_target(${TARGET_NAME} ALL
-    ${SHADER_COMMANDS}
-    COMMENT "Compiling Shaders [${TARGET_NAME}]"
+    DEPENDS ${SHADER_PRODUCTS}
     SOURCES ${SHADER_SOURCE_FILES}
-    BYPRODUCTS ${SHADER_PRODUCTS}
   )
 endfunction()
@@ -0,0 +1,48 @@
+# Writes a SPIR-V binary as a C++ header holding a constexpr std::array of its words, run in script mode:
+#   cmake -DINPUT=<file.spv> -DOUTPUT=<file.hpp> -DSHADER_NAME=<triangle.vert> -P EmbedSpirv.cmake
+# The array is named after the shader, e.g. 'triangle.vert' becomes 'vt::shaders::kTriangleVert'.
+
+file(READ "${INPUT}" SPIRV_HEX HEX)
+
+string(LENGTH "${SPIRV_HEX}" SPIRV_HEX_LENGTH)
+math(EXPR SPIRV_BYTE_REMAINDER "${SPIRV_HEX_LENGTH} % 8")
+if(NOT SPIRV_BYTE_REMAINDER EQUAL 0)
+  message(FATAL_ERROR "EmbedSpirv: [${INPUT}] is not a whole number of 32-bit words.")
+endif()
+math(EXPR SPIRV_WORD_COUNT "${SPIRV_HEX_LENGTH} / 8")
+
+# glslc and spirv-opt write little endian words, reassembling them here keeps the array correct on any host.
+string(REGEX REPLACE "(..)(..)(..)(..)" "0x\\4\\3\\2\\1U, " SPIRV_WORDS "${SPIRV_HEX}")
+
+# CMake regular expressions have no {n} repetition, hence the spelled out eight words per line.
+set(WORD "0x[0-9a-f]+U, ")
+string(REGEX REPLACE "(${WORD}${WORD}${WORD}${WORD}${WORD}${WORD}${WORD}${WORD})" "\\1\n    " SPIRV_WORDS "${SPIRV_WORDS}")
+string(REPLACE ", \n" ",\n" SPIRV_WORDS "${SPIRV_WORDS}")
+string(STRIP "${SPIRV_WORDS}" SPIRV_WORDS)
+
+set(ARRAY_NAME "k")
+string(REGEX MATCHALL "[A-Za-z0-9]+" NAME_PARTS "${SHADER_NAME}")
+foreach(NAME_PART IN LISTS NAME_PARTS)
+  string(SUBSTRING "${NAME_PART}" 0 1 FIRST_LETTER)
+  string(SUBSTRING "${NAME_PART}" 1 -1 OTHER_LETTERS)
+  string(TOUPPER "${FIRST_LETTER}" FIRST_LETTER)
+  string(APPEND ARRAY_NAME "${FIRST_LETTER}${OTHER_LETTERS}")
+endforeach()
+
+set(HEADER_CONTENT "// Generated from ${SHADER_NAME} by EmbedSpirv.cmake, do not edit.
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+namespace vt::shaders {
+
+inline constexpr std::array<uint32_t, ${SPIRV_WORD_COUNT}> ${ARRAY_NAME} = {
+    ${SPIRV_WORDS}
+};
+
+}  // namespace vt::shaders
+")
+
+# Only touch the header when it changed, so that an identical recompile doesn't rebuild the application.
+file(CONFIGURE OUTPUT "${OUTPUT}" CONTENT "${HEADER_CONTENT}" @ONLY)
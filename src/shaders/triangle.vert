@@ -1,20 +1,47 @@
 #version 450
 
+struct Instance {
+    vec2  offset;
+    float scale;
+    float rotation;
+    vec3  color;
+    float depth;
+};
+
+layout(std430, set = 0, binding = 0) readonly buffer Instances {
+    Instance instances[];
+};
+
+layout(push_constant) uniform View {
+    vec2  viewOffset;
+    float viewZoom;
+};
+
+layout(location = 0) in vec2 inPosition;
+layout(location = 1) in vec3 inColor;
+
 layout(location = 0) out vec3 fragColor;
 
-vec2 positions[3] = vec2[](
-    vec2( 0.0, -0.5),
-    vec2( 0.5,  0.5),
-    vec2(-0.5,  0.5)
-);
+// HelloTriangleApplication::ColorMode, a specialization constant so that the unused branches are compiled out of each pipeline variant.
+layout(constant_id = 0) const uint colorMode = 0;
 
-vec3 colors[3] = vec3[](
-    vec3(1.0, 0.0, 0.0),
-    vec3(0.0, 1.0, 0.0),
-    vec3(0.0, 0.0, 1.0)
-);
+const uint COLOR_MODE_MIXED    = 0;
+const uint COLOR_MODE_VERTEX   = 1;
+const uint COLOR_MODE_INSTANCE = 2;
 
 void main() {
-    gl_Position = vec4(positions[gl_VertexIndex], 0.0, 1.0);
-    fragColor = colors[gl_VertexIndex];
+    Instance instance = instances[gl_InstanceIndex];
+
+    float s = sin(instance.rotation);
+    float c = cos(instance.rotation);
+    vec2 position = mat2(c, s, -s, c) * inPosition * instance.scale + instance.offset;
+
+    gl_Position = vec4((position - viewOffset) * viewZoom, instance.depth, 1.0);
+    if (colorMode == COLOR_MODE_VERTEX) {
+        fragColor = inColor;
+    } else if (colorMode == COLOR_MODE_INSTANCE) {
+        fragColor = instance.color;
+    } else {
+        fragColor = inColor * instance.color;
+    }
 }
@@ -0,0 +1,51 @@
+#include "staging_ring.hpp"
+
+#include <cstdint>
+#include <optional>
+
+namespace vt::memory {
+
+auto StagingRing::TryAllocate(VkDeviceSize size, VkDeviceSize alignment) -> std::optional<VkDeviceSize> {
+    // An empty ring starts over at offset 0, which keeps large requests from wrapping needlessly.
+    if (0 == m_used) {
+        m_head = 0;
+    }
+
+    VkDeviceSize offset = (m_head + alignment - 1) / alignment * alignment;
+    if (offset + size > m_size) {
+        offset = 0;
+    }
+
+    // Bytes consumed from the head, including the alignment padding or the skipped tail of the ring.
+    const VkDeviceSize consumed = 0 == offset && 0 != m_head ? m_size - m_head + size : offset - m_head + size;
+    if (size > m_size || consumed > m_size - m_used) {
+        return std::nullopt;
+    }
+
+    m_head       = offset + size;
+    m_used      += consumed;
+    m_openBytes += consumed;
+    return offset;
+}
+
+void StagingRing::CloseBatch(uint64_t value) {
+    if (0 == m_openBytes) {
+        return;
+    }
+
+    m_batches.push_back({ .bytes = m_openBytes, .value = value });
+    m_openBytes = 0;
+}
+
+void StagingRing::Retire(uint64_t completedValue) {
+    while (!m_batches.empty() && m_batches.front().value <= completedValue) {
+        m_used -= m_batches.front().bytes;
+        m_batches.pop_front();
+    }
+}
+
+auto StagingRing::OldestBatchValue() const -> std::optional<uint64_t> {
+    return m_batches.empty() ? std::nullopt : std::optional<uint64_t>(m_batches.front().value);
+}
+
+}  // namespace vt::memory
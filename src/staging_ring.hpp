@@ -0,0 +1,50 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include <cstdint>
+#include <deque>
+#include <optional>
+
+namespace vt::memory {
+
+// Bookkeeping of a ring shaped staging buffer, without any Vulkan objects of its own. Space is handed out in submission order
+// and grouped in batches, each batch is freed as a whole once the timeline value it was submitted with has been reached.
+// Since batches retire in order, the free space is always a single contiguous range from the head, wrapping around, to the oldest batch.
+class StagingRing {
+  public:
+    explicit StagingRing(VkDeviceSize size) : m_size(size) {}
+
+    // Returns the offset of 'size' bytes aligned to 'alignment', or nullopt until enough older batches have retired.
+    // A request that doesn't fit in front of the end of the ring wraps around to offset 0, the skipped tail belongs to the current batch.
+    auto TryAllocate(VkDeviceSize size, VkDeviceSize alignment) -> std::optional<VkDeviceSize>;
+
+    // Closes the current batch, its space is freed by Retire once the timeline has reached 'value'.
+    void CloseBatch(uint64_t value);
+
+    // Frees every batch with a value of at most 'completedValue'.
+    void Retire(uint64_t completedValue);
+
+    [[nodiscard]] auto Size() const -> VkDeviceSize { return m_size; }
+    [[nodiscard]] auto UsedBytes() const -> VkDeviceSize { return m_used; }
+    [[nodiscard]] auto HasOpenBatch() const -> bool { return 0 != m_openBytes; }
+
+    // Timeline value of the oldest batch still in flight, the one to wait for when TryAllocate fails.
+    [[nodiscard]] auto OldestBatchValue() const -> std::optional<uint64_t>;
+
+  private:
+    struct Batch {
+        // NOLINTBEGIN(misc-non-private-member-variables-in-classes)
+        VkDeviceSize bytes = 0;  // Including alignment padding and a skipped tail.
+        uint64_t     value = 0;
+        // NOLINTEND(misc-non-private-member-variables-in-classes)
+    };
+
+    VkDeviceSize      m_size      = 0;
+    VkDeviceSize      m_head      = 0;
+    VkDeviceSize      m_used      = 0;
+    VkDeviceSize      m_openBytes = 0;
+    std::deque<Batch> m_batches;
+};
+
+}  // namespace vt::memory
@@ -0,0 +1,131 @@
+#include "task_graph.hpp"
+
+#include <cstdint>
+#include <exception>
+#include <format>
+#include <functional>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "trace.hpp"
+
+namespace vt::threading {
+
+auto TaskGraph::Add(const char* name, const std::vector<TaskId>& dependencies, std::function<void()> work, Affinity affinity) -> TaskId {
+    const auto id = static_cast<TaskId>(m_tasks.size());
+
+    for (const TaskId dependency : dependencies) {
+        if (dependency >= id) {
+            throw std::invalid_argument(std::format("TaskGraph::Add: Task [{}] depends on a task that was not added before it.", name));
+        }
+        m_tasks[dependency].dependents.push_back(id);
+    }
+
+    m_tasks.push_back({ .name                  = name,
+                        .work                  = std::move(work),
+                        .affinity              = affinity,
+                        .dependents            = {},
+                        .dependencyCount       = static_cast<uint32_t>(dependencies.size()),
+                        .remainingDependencies = 0 });
+    return id;
+}
+
+void TaskGraph::Run(uint32_t workerCount) {
+    m_timings.assign(m_tasks.size(), {});
+    m_ready.clear();
+    m_mainThreadReady.clear();
+    m_unfinished = static_cast<uint32_t>(m_tasks.size());
+    m_exception  = nullptr;
+
+    for (TaskId id = 0; id < m_tasks.size(); id++) {
+        m_tasks[id].remainingDependencies = m_tasks[id].dependencyCount;
+        if (0 == m_tasks[id].dependencyCount) {
+            MakeReady(id);
+        }
+    }
+
+    std::vector<std::thread> workers;
+    workers.reserve(workerCount);
+    for (uint32_t i = 1; i <= workerCount; i++) {
+        workers.emplace_back([this, i]() {
+            trace::SetThreadName(std::format("task graph {}", i));
+            Work(i);
+        });
+    }
+
+    Work(0);
+
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    if (m_exception) {
+        std::rethrow_exception(std::exchange(m_exception, nullptr));
+    }
+}
+
+void TaskGraph::Work(uint32_t thread) {
+    std::unique_lock lock(m_mutex);
+
+    while (true) {
+        // The calling thread prefers the tasks only it may run, so that they never wait behind tasks any worker could have taken.
+        std::deque<TaskId>* queue = nullptr;
+        m_condition.wait(lock, [&]() {
+            if (0 == thread && !m_mainThreadReady.empty()) {
+                queue = &m_mainThreadReady;
+            } else if (!m_ready.empty()) {
+                queue = &m_ready;
+            }
+            return nullptr != queue || 0 == m_unfinished || nullptr != m_exception;
+        });
+
+        if (0 == m_unfinished || nullptr != m_exception) {
+            return;
+        }
+
+        const TaskId id = queue->front();
+        queue->pop_front();
+        Task& task = m_tasks[id];
+        lock.unlock();
+
+        std::exception_ptr exception = nullptr;
+        const auto         begin     = Clock::now();
+        try {
+            task.work();
+        } catch (...) {
+            exception = std::current_exception();
+        }
+        const auto end = Clock::now();
+
+        lock.lock();
+        m_timings[id] = { .name = task.name, .begin = begin, .end = end, .thread = thread };
+
+        if (exception) {
+            if (!m_exception) {
+                m_exception = exception;
+            }
+        } else {
+            m_unfinished--;
+            for (const TaskId dependent : task.dependents) {
+                if (0 == --m_tasks[dependent].remainingDependencies) {
+                    MakeReady(dependent);
+                }
+            }
+        }
+
+        m_condition.notify_all();
+    }
+}
+
+void TaskGraph::MakeReady(TaskId task) {
+    if (Affinity::MAIN_THREAD == m_tasks[task].affinity) {
+        m_mainThreadReady.push_back(task);
+    } else {
+        m_ready.push_back(task);
+    }
+}
+
+}  // namespace vt::threading
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+namespace vt::threading {
+
+// Runs a set of named tasks, each as soon as every task it depends on has finished, on the calling thread and a few worker threads.
+// A task can only depend on tasks added before it, so the graph never contains a cycle.
+class TaskGraph {
+  public:
+    using TaskId = uint32_t;
+    using Clock  = std::chrono::steady_clock;
+
+    // MAIN_THREAD tasks only ever run on the thread calling Run, e.g. for GLFW functions that must be called from the main thread.
+    enum class Affinity : uint8_t { ANY, MAIN_THREAD };
+
+    struct TaskTiming {
+        // NOLINTBEGIN(misc-non-private-member-variables-in-classes)
+        const char*       name   = nullptr;
+        Clock::time_point begin  = {};
+        Clock::time_point end    = {};
+        uint32_t          thread = 0;  // 0 is the thread calling Run, 1 to N the workers.
+        // NOLINTEND(misc-non-private-member-variables-in-classes)
+    };
+
+    TaskGraph()           = default;
+    ~TaskGraph() noexcept = default;
+
+    // Copy constructor and assignment operator.
+    TaskGraph(const TaskGraph& other)                    = delete;
+    auto operator=(const TaskGraph& other) -> TaskGraph& = delete;
+
+    // Move constructor and move assignment operator.
+    TaskGraph(TaskGraph&& other) noexcept                    = delete;
+    auto operator=(TaskGraph&& other) noexcept -> TaskGraph& = delete;
+
+    // 'name' must outlive the graph's timings, in practice a string literal.
+    auto Add(const char* name, const std::vector<TaskId>& dependencies, std::function<void()> work, Affinity affinity = Affinity::ANY) -> TaskId;
+
+    // Runs every task and blocks until all of them have finished, with 'workerCount' threads besides the calling one, 0 runs everything on the
+    // calling thread. Once a task has thrown no further tasks are started, and the first exception is rethrown after the running ones returned.
+    void Run(uint32_t workerCount);
+
+    // One entry per task in the order they were added, filled in by Run.
+    [[nodiscard]] auto GetTimings() const -> const std::vector<TaskTiming>& { return m_timings; }
+
+  private:
+    struct Task {
+        // NOLINTBEGIN(misc-non-private-member-variables-in-classes)
+        const char*           name                  = nullptr;
+        std::function<void()> work;
+        Affinity              affinity              = Affinity::ANY;
+        std::vector<TaskId>   dependents;
+        uint32_t              dependencyCount       = 0;
+        uint32_t              remainingDependencies = 0;
+        // NOLINTEND(misc-non-private-member-variables-in-classes)
+    };
+
+    void Work(uint32_t thread);
+    void MakeReady(TaskId task);
+
+    std::vector<Task>       m_tasks;
+    std::vector<TaskTiming> m_timings;
+
+    std::mutex              m_mutex;
+    std::condition_variable m_condition;
+    std::deque<TaskId>      m_ready;
+    std::deque<TaskId>      m_mainThreadReady;
+    uint32_t                m_unfinished = 0;
+    std::exception_ptr      m_exception;
+};
+
+}  // namespace vt::threading
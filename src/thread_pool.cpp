@@ -0,0 +1,86 @@
+#include "thread_pool.hpp"
+
+#include <cstdint>
+#include <exception>
+#include <format>
+#include <functional>
+#include <mutex>
+#include <utility>
+
+#include "trace.hpp"
+
+namespace vt::threading {
+
+ThreadPool::ThreadPool(uint32_t threadCount) {
+    m_threads.reserve(threadCount);
+    for (uint32_t i = 0; i < threadCount; i++) {
+        m_threads.emplace_back([this, i]() { WorkerLoop(i); });
+    }
+}
+
+ThreadPool::~ThreadPool() noexcept {
+    {
+        const std::scoped_lock lock(m_mutex);
+        m_stop = true;
+    }
+    m_startCondition.notify_all();
+
+    for (auto& thread : m_threads) {
+        thread.join();
+    }
+}
+
+void ThreadPool::RunOnAll(const std::function<void(uint32_t)>& task) {
+    std::unique_lock lock(m_mutex);
+    m_task    = &task;
+    m_pending = Size();
+    m_generation++;
+    m_startCondition.notify_all();
+
+    m_doneCondition.wait(lock, [this]() { return 0 == m_pending; });
+    m_task = nullptr;
+
+    if (m_exception) {
+        std::rethrow_exception(std::exchange(m_exception, nullptr));
+    }
+}
+
+void ThreadPool::WorkerLoop(uint32_t workerIndex) {
+    trace::SetThreadName(std::format("worker {}", workerIndex));
+    uint64_t seenGeneration = 0;
+
+    while (true) {
+        const std::function<void(uint32_t)>* task = nullptr;
+        {
+            std::unique_lock lock(m_mutex);
+            m_startCondition.wait(lock, [&]() { return m_stop || m_generation != seenGeneration; });
+
+            if (m_stop) {
+                return;
+            }
+
+            seenGeneration = m_generation;
+            task           = m_task;
+        }
+
+        std::exception_ptr exception = nullptr;
+        try {
+            (*task)(workerIndex);
+        } catch (...) {
+            exception = std::current_exception();
+        }
+
+        {
+            const std::scoped_lock lock(m_mutex);
+            if (exception && !m_exception) {
+                m_exception = exception;
+            }
+
+            if (0 == --m_pending) {
+                m_doneCondition.notify_one();
+            }
+        }
+    }
+}
+
+}  // namespace vt::threading
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace vt::threading {
+
+// A fixed set of worker threads that all run the same task once per dispatch.
+// Every worker is always handed the same index, so per-worker resources (e.g. command pools) are never shared between threads.
+class ThreadPool {
+  public:
+    explicit ThreadPool(uint32_t threadCount);
+    ~ThreadPool() noexcept;
+
+    // Copy constructor and assignment operator.
+    ThreadPool(const ThreadPool& other)                    = delete;
+    auto operator=(const ThreadPool& other) -> ThreadPool& = delete;
+
+    // Move constructor and move assignment operator.
+    ThreadPool(ThreadPool&& other) noexcept                    = delete;
+    auto operator=(ThreadPool&& other) noexcept -> ThreadPool& = delete;
+
+    // Runs 'task(workerIndex)' once on every worker and blocks until all of them have returned.
+    // The first exception thrown by a worker is rethrown on the calling thread.
+    void RunOnAll(const std::function<void(uint32_t)>& task);
+
+    [[nodiscard]] auto Size() const -> uint32_t { return static_cast<uint32_t>(m_threads.size()); }
+
+  private:
+    void WorkerLoop(uint32_t workerIndex);
+
+    std::vector<std::thread>             m_threads;
+    std::mutex                           m_mutex;
+    std::condition_variable              m_startCondition;
+    std::condition_variable              m_doneCondition;
+    const std::function<void(uint32_t)>* m_task       = nullptr;
+    uint64_t                             m_generation = 0;
+    uint32_t                             m_pending    = 0;
+    bool                                 m_stop       = false;
+    std::exception_ptr                   m_exception;
+};
+
+}  // namespace vt::threading
@@ -0,0 +1,190 @@
+#include "trace.hpp"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdint>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace vt::trace {
+
+namespace {
+
+struct Event {
+    const char*       name = nullptr;
+    Clock::time_point begin;
+    Clock::time_point end;
+};
+
+constexpr size_t kChunkSize = 4096;
+constexpr size_t kMaxChunks = 256;  // Up to a million zones per thread, later zones are dropped and counted.
+
+// Only ever written by its owning thread. A zone is published by the release store to 'count', so the writer
+// of the trace can read everything below 'count' from another thread without a lock. Chunks are never moved or freed while
+// the buffer is alive, and the registry keeps the buffer alive after its thread has exited.
+struct ThreadBuffer {
+    // NOLINTBEGIN(misc-non-private-member-variables-in-classes)
+    std::array<std::unique_ptr<std::array<Event, kChunkSize>>, kMaxChunks> chunks;
+    std::atomic<size_t>                                                   count    = 0;
+    std::atomic<uint64_t>                                                 dropped  = 0;
+    std::array<char, 32>                                                  name     = {};
+    std::atomic<bool>                                                     hasName  = false;  // Publishes 'name', which is only set once.
+    uint32_t                                                              threadId = 0;
+    // NOLINTEND(misc-non-private-member-variables-in-classes)
+};
+
+struct Registry {
+    // NOLINTBEGIN(misc-non-private-member-variables-in-classes)
+    std::mutex                                 mutex;
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+    // NOLINTEND(misc-non-private-member-variables-in-classes)
+};
+
+// Zone and thread names are written into JSON strings, escaped so that any name still produces a valid trace.
+auto Escape(std::string_view text) -> std::string {
+    std::string escaped;
+    escaped.reserve(text.size());
+
+    for (const char character : text) {
+        if ('"' == character || '\\' == character) {
+            escaped.push_back('\\');
+            escaped.push_back(character);
+        } else if (static_cast<unsigned char>(character) < 0x20) {
+            escaped += std::format("\\u{:04x}", static_cast<unsigned int>(character));
+        } else {
+            escaped.push_back(character);
+        }
+    }
+
+    return escaped;
+}
+
+auto GetRegistry() -> Registry& {
+    static Registry registry;
+    return registry;
+}
+
+// The registry lock is only taken once per thread, the first time it records a zone.
+auto LocalBuffer() -> ThreadBuffer& {
+    thread_local const std::shared_ptr<ThreadBuffer> buffer = []() {
+        auto                   newBuffer = std::make_shared<ThreadBuffer>();
+        Registry&              registry  = GetRegistry();
+        const std::scoped_lock lock(registry.mutex);
+
+        newBuffer->threadId = static_cast<uint32_t>(registry.buffers.size());
+        registry.buffers.push_back(newBuffer);
+        return newBuffer;
+    }();
+
+    return *buffer;
+}
+
+const Clock::time_point kStartTime = Clock::now();
+
+static_assert(std::atomic<bool>::is_always_lock_free, "The dump request flag is set from a signal handler.");
+std::atomic<bool> dumpRequested = false;  // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
+
+void HandleDumpSignal(int /*signal*/) {
+    dumpRequested.store(true, std::memory_order_relaxed);
+}
+
+auto ToMicroseconds(Clock::duration duration) -> double {
+    return std::chrono::duration<double, std::micro>(duration).count();
+}
+
+}  // namespace
+
+void detail::Record(const char* name, Clock::time_point begin, Clock::time_point end) {
+    ThreadBuffer& buffer = LocalBuffer();
+    const size_t  index  = buffer.count.load(std::memory_order_relaxed);
+    const size_t  chunk  = index / kChunkSize;
+
+    if (chunk >= kMaxChunks) {
+        buffer.dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    if (nullptr == buffer.chunks[chunk]) {
+        buffer.chunks[chunk] = std::make_unique<std::array<Event, kChunkSize>>();
+    }
+
+    (*buffer.chunks[chunk])[index % kChunkSize] = { .name = name, .begin = begin, .end = end };
+    buffer.count.store(index + 1, std::memory_order_release);
+}
+
+void SetEnabled(bool enabled) {
+    detail::enabled.store(enabled, std::memory_order_relaxed);
+}
+
+void SetThreadName(std::string_view name) {
+    ThreadBuffer& buffer = LocalBuffer();
+    if (buffer.hasName.load(std::memory_order_relaxed)) {
+        return;
+    }
+
+    name.copy(buffer.name.data(), buffer.name.size() - 1);
+    buffer.hasName.store(true, std::memory_order_release);
+}
+
+void WriteChromeTrace(const std::filesystem::path& path) {
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+    {
+        Registry&              registry = GetRegistry();
+        const std::scoped_lock lock(registry.mutex);
+        buffers = registry.buffers;
+    }
+
+    std::ofstream file(path, std::ios::trunc);
+    if (!file.is_open()) {
+        throw std::runtime_error(std::format("Trace::WriteChromeTrace: Failed to open file: [{}].", path.string()));
+    }
+
+    uint64_t dropped   = 0;
+    bool     separator = false;
+    file << R"({ "displayTimeUnit": "ms", "traceEvents": [)" "\n";
+
+    for (const auto& buffer : buffers) {
+        if (buffer->hasName.load(std::memory_order_acquire)) {
+            file << std::format(R"({}  {{ "name": "thread_name", "ph": "M", "pid": 1, "tid": {}, "args": {{ "name": "{}" }} }})", separator ? ",\n" : "",
+                                buffer->threadId, Escape(buffer->name.data()));
+            separator = true;
+        }
+
+        const size_t count = buffer->count.load(std::memory_order_acquire);
+        for (size_t i = 0; i < count; i++) {
+            const Event& event = (*buffer->chunks[i / kChunkSize])[i % kChunkSize];
+            file << std::format(R"({}  {{ "name": "{}", "ph": "X", "pid": 1, "tid": {}, "ts": {:.3f}, "dur": {:.3f} }})", separator ? ",\n" : "", Escape(event.name),
+                                buffer->threadId, ToMicroseconds(event.begin - kStartTime), ToMicroseconds(event.end - event.begin));
+            separator = true;
+        }
+
+        dropped += buffer->dropped.load(std::memory_order_relaxed);
+    }
+
+    file << std::format("\n], \"otherData\": {{ \"droppedZones\": {} }} }}\n", dropped);
+
+    if (!file) {
+        throw std::runtime_error(std::format("Trace::WriteChromeTrace: Failed to write file: [{}].", path.string()));
+    }
+}
+
+void InstallDumpSignalHandler() {
+#ifdef SIGUSR1
+    std::signal(SIGUSR1, HandleDumpSignal);
+#endif
+}
+
+auto ConsumeDumpRequest() -> bool {
+    return dumpRequested.exchange(false, std::memory_order_relaxed);
+}
+
+}  // namespace vt::trace
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <string_view>
+
+namespace vt::trace {
+
+using Clock = std::chrono::steady_clock;
+
+namespace detail {
+inline std::atomic<bool> enabled = false;  // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
+
+void Record(const char* name, Clock::time_point begin, Clock::time_point end);
+}  // namespace detail
+
+// Tracing is compiled in everywhere and switched on at runtime. While disabled a zone costs one relaxed load and a branch.
+inline auto IsEnabled() -> bool {
+    return detail::enabled.load(std::memory_order_relaxed);
+}
+
+void SetEnabled(bool enabled);
+
+// Names the calling thread in the trace, e.g. "main" or "worker 2". Only the first name set sticks, truncated to 31 characters.
+void SetThreadName(std::string_view name);
+
+// Records a zone from time points the caller already has, so existing timing code doesn't need to read the clock twice.
+// 'name' must outlive the trace, in practice a string literal.
+inline void RecordZone(const char* name, Clock::time_point begin, Clock::time_point end) {
+    if (IsEnabled()) {
+        detail::Record(name, begin, end);
+    }
+}
+
+// Records the lifetime of the scope it is declared in, use through VT_TRACE_ZONE.
+class Zone {
+  public:
+    explicit Zone(const char* name) : m_name(IsEnabled() ? name : nullptr) {
+        if (nullptr != m_name) {
+            m_begin = Clock::now();
+        }
+    }
+
+    ~Zone() noexcept {
+        if (nullptr != m_name) {
+            detail::Record(m_name, m_begin, Clock::now());
+        }
+    }
+
+    // Copy constructor and assignment operator.
+    Zone(const Zone& other)                    = delete;
+    auto operator=(const Zone& other) -> Zone& = delete;
+
+    // Move constructor and move assignment operator.
+    Zone(Zone&& other) noexcept                    = delete;
+    auto operator=(Zone&& other) noexcept -> Zone& = delete;
+
+  private:
+    const char*       m_name = nullptr;
+    Clock::time_point m_begin;
+};
+
+// Writes every zone recorded so far as Chrome trace-event JSON, which loads in chrome://tracing and ui.perfetto.dev.
+// Safe to call while other threads keep recording, zones recorded during the write may or may not be included.
+void WriteChromeTrace(const std::filesystem::path& path);
+
+// On POSIX, SIGUSR1 requests a trace dump. The handler only sets a flag, the dump itself happens on the next ConsumeDumpRequest.
+void InstallDumpSignalHandler();
+auto ConsumeDumpRequest() -> bool;
+
+}  // namespace vt::trace
+
+#define VT_TRACE_CONCAT_INNER(a, b) a##b
+#define VT_TRACE_CONCAT(a, b)       VT_TRACE_CONCAT_INNER(a, b)
+
+// NOLINTNEXTLINE(cppcoreguidelines-macro-usage)
+#define VT_TRACE_ZONE(name) const ::vt::trace::Zone VT_TRACE_CONCAT(vtTraceZone, __LINE__)(name)
@@ -0,0 +1,256 @@
+#include "uploader.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <format>
+#include <span>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "trace.hpp"
+
+namespace vt::memory {
+
+Uploader::Uploader(VkDevice device, DeviceAllocator& allocator, VkQueue queue, uint32_t queueFamilyIndex, uint32_t graphicsFamilyIndex, VkDeviceSize ringSize)
+    : m_device(device),
+      m_allocator(allocator),
+      m_queue(queue),
+      m_queueFamilyIndex(queueFamilyIndex),
+      m_graphicsFamilyIndex(graphicsFamilyIndex),
+      m_ring(ringSize) {
+    m_stats.dedicatedQueue = m_queueFamilyIndex != m_graphicsFamilyIndex;
+
+    const VkCommandPoolCreateInfo poolInfo = { .sType            = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
+                                               .pNext            = nullptr,
+                                               .flags            = static_cast<VkCommandPoolCreateFlags>(VK_COMMAND_POOL_CREATE_TRANSIENT_BIT) |
+                                                                   static_cast<VkCommandPoolCreateFlags>(VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT),
+                                               .queueFamilyIndex = m_queueFamilyIndex };
+
+    if (const auto& result = vkCreateCommandPool(m_device, &poolInfo, nullptr, &m_commandPool) != VK_SUCCESS) {
+        throw std::runtime_error(std::format("Uploader::Uploader: Failed to create command pool, error code: {}.", result));
+    }
+
+    VkSemaphoreTypeCreateInfo timelineInfo = {};
+    timelineInfo.sType                     = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO;
+    timelineInfo.semaphoreType             = VK_SEMAPHORE_TYPE_TIMELINE;
+    timelineInfo.initialValue              = 0;
+
+    const VkSemaphoreCreateInfo semaphoreInfo = { .sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO, .pNext = &timelineInfo, .flags = {} };
+    if (const auto& result = vkCreateSemaphore(m_device, &semaphoreInfo, nullptr, &m_timeline) != VK_SUCCESS) {
+        vkDestroyCommandPool(m_device, m_commandPool, nullptr);
+        throw std::runtime_error(std::format("Uploader::Uploader: Failed to create timeline semaphore, error code: {}.", result));
+    }
+
+    m_ringBuffer = m_allocator.CreateBuffer(ringSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+                                            static_cast<VkMemoryPropertyFlags>(VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) |
+                                                static_cast<VkMemoryPropertyFlags>(VK_MEMORY_PROPERTY_HOST_COHERENT_BIT));
+}
+
+Uploader::~Uploader() noexcept {
+    // The command buffers may still be executing, the owner is expected to have waited for the device to be idle.
+    m_allocator.DestroyBuffer(m_ringBuffer);
+    vkDestroySemaphore(m_device, m_timeline, nullptr);
+    vkDestroyCommandPool(m_device, m_commandPool, nullptr);
+}
+
+void Uploader::Upload(VkBuffer dst, VkDeviceSize dstOffset, std::span<const std::byte> data, VkPipelineStageFlags2 dstStageMask, VkAccessFlags2 dstAccessMask) {
+    if (data.empty()) {
+        return;
+    }
+
+    // Chunks of a quarter of the ring let the next chunk be written while earlier ones are still being copied.
+    const VkDeviceSize maxChunk = std::max<VkDeviceSize>(m_ring.Size() / 4, kAlignment);
+    for (VkDeviceSize done = 0; done < data.size();) {
+        const VkDeviceSize chunk  = std::min<VkDeviceSize>(maxChunk, data.size() - done);
+        const VkDeviceSize offset = AllocateStaging(chunk);
+
+        std::memcpy(static_cast<std::byte*>(m_ringBuffer.allocation.mapped) + offset, data.data() + done, chunk);
+
+        const VkBufferCopy region = { .srcOffset = offset, .dstOffset = dstOffset + done, .size = chunk };
+        vkCmdCopyBuffer(CurrentCommandBuffer(), m_ringBuffer.buffer, dst, 1, &region);
+        done += chunk;
+    }
+
+    // With a shared queue the copies are ordered by a plain barrier on the graphics queue, otherwise it is the acquire half of an ownership transfer.
+    const bool dedicated = m_stats.dedicatedQueue;
+    m_releases.push_back({ .sType               = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2,
+                           .pNext               = nullptr,
+                           .srcStageMask        = dedicated ? VK_PIPELINE_STAGE_2_NONE : VK_PIPELINE_STAGE_2_COPY_BIT,
+                           .srcAccessMask       = dedicated ? VK_ACCESS_2_NONE : VK_ACCESS_2_TRANSFER_WRITE_BIT,
+                           .dstStageMask        = dstStageMask,
+                           .dstAccessMask       = dstAccessMask,
+                           .srcQueueFamilyIndex = dedicated ? m_queueFamilyIndex : VK_QUEUE_FAMILY_IGNORED,
+                           .dstQueueFamilyIndex = dedicated ? m_graphicsFamilyIndex : VK_QUEUE_FAMILY_IGNORED,
+                           .buffer              = dst,
+                           .offset              = dstOffset,
+                           .size                = data.size() });
+
+    m_stats.uploadedBytes += data.size();
+}
+
+void Uploader::Flush() {
+    if (VK_NULL_HANDLE == m_recording) {
+        return;
+    }
+
+    VT_TRACE_ZONE("Uploader::Flush");
+
+    // The release half of each ownership transfer. Its destination scope is ignored, the graphics queue's acquire and semaphore wait provide it.
+    if (m_stats.dedicatedQueue && !m_releases.empty()) {
+        std::vector<VkBufferMemoryBarrier2> releases = m_releases;
+        for (auto& release : releases) {
+            release.srcStageMask  = VK_PIPELINE_STAGE_2_COPY_BIT;
+            release.srcAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT;
+            release.dstStageMask  = VK_PIPELINE_STAGE_2_NONE;
+            release.dstAccessMask = VK_ACCESS_2_NONE;
+        }
+
+        const VkDependencyInfo dependencyInfo = { .sType                    = VK_STRUCTURE_TYPE_DEPENDENCY_INFO,
+                                                  .pNext                    = nullptr,
+                                                  .dependencyFlags          = {},
+                                                  .memoryBarrierCount       = 0,
+                                                  .pMemoryBarriers          = nullptr,
+                                                  .bufferMemoryBarrierCount = static_cast<uint32_t>(releases.size()),
+                                                  .pBufferMemoryBarriers    = releases.data(),
+                                                  .imageMemoryBarrierCount  = 0,
+                                                  .pImageMemoryBarriers     = nullptr };
+        vkCmdPipelineBarrier2(m_recording, &dependencyInfo);
+    }
+
+    if (const auto& result = vkEndCommandBuffer(m_recording) != VK_SUCCESS) {
+        throw std::runtime_error(std::format("Uploader::Flush: Failed to end command buffer, error code: {}.", result));
+    }
+
+    const uint64_t                  value             = m_lastValue + 1;
+    const VkCommandBufferSubmitInfo commandBufferInfo = { .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_SUBMIT_INFO, .pNext = nullptr, .commandBuffer = m_recording, .deviceMask = 0 };
+    const VkSemaphoreSubmitInfo     signalInfo        = { .sType       = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO,
+                                                          .pNext       = nullptr,
+                                                          .semaphore   = m_timeline,
+                                                          .value       = value,
+                                                          .stageMask   = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT,
+                                                          .deviceIndex = 0 };
+    const VkSubmitInfo2             submitInfo        = { .sType                    = VK_STRUCTURE_TYPE_SUBMIT_INFO_2,
+                                                          .pNext                    = nullptr,
+                                                          .flags                    = {},
+                                                          .waitSemaphoreInfoCount   = 0,
+                                                          .pWaitSemaphoreInfos      = nullptr,
+                                                          .commandBufferInfoCount   = 1,
+                                                          .pCommandBufferInfos      = &commandBufferInfo,
+                                                          .signalSemaphoreInfoCount = 1,
+                                                          .pSignalSemaphoreInfos    = &signalInfo };
+
+    if (const auto& result = vkQueueSubmit2(m_queue, 1, &submitInfo, VK_NULL_HANDLE) != VK_SUCCESS) {
+        throw std::runtime_error(std::format("Uploader::Flush: Failed to submit uploads, error code: {}.", result));
+    }
+
+    m_lastValue = value;
+    m_ring.CloseBatch(value);
+    m_submissions.push_back({ .commandBuffer = std::exchange(m_recording, VK_NULL_HANDLE), .value = value });
+
+    m_acquires.insert(m_acquires.end(), m_releases.begin(), m_releases.end());
+    m_releases.clear();
+    m_acquireValue = value;
+    m_stats.submissions++;
+}
+
+auto Uploader::RecordAcquire(VkCommandBuffer commandBuffer) -> Handover {
+    if (m_acquires.empty()) {
+        return {};
+    }
+
+    Handover handover = { .value = m_acquireValue, .stageMask = VK_PIPELINE_STAGE_2_NONE };
+    for (const auto& acquire : m_acquires) {
+        handover.stageMask |= acquire.dstStageMask;
+    }
+
+    const VkDependencyInfo dependencyInfo = { .sType                    = VK_STRUCTURE_TYPE_DEPENDENCY_INFO,
+                                              .pNext                    = nullptr,
+                                              .dependencyFlags          = {},
+                                              .memoryBarrierCount       = 0,
+                                              .pMemoryBarriers          = nullptr,
+                                              .bufferMemoryBarrierCount = static_cast<uint32_t>(m_acquires.size()),
+                                              .pBufferMemoryBarriers    = m_acquires.data(),
+                                              .imageMemoryBarrierCount  = 0,
+                                              .pImageMemoryBarriers     = nullptr };
+    vkCmdPipelineBarrier2(commandBuffer, &dependencyInfo);
+
+    m_acquires.clear();
+    return handover;
+}
+
+auto Uploader::AllocateStaging(VkDeviceSize size) -> VkDeviceSize {
+    m_ring.Retire(CompletedValue());
+
+    auto offset = m_ring.TryAllocate(size, kAlignment);
+    while (!offset.has_value()) {
+        // Out of ring space. Submit what was written so far, it may hold the space we are waiting for, then wait for the oldest batch.
+        VT_TRACE_ZONE("Uploader::RingStall");
+        m_stats.ringStalls++;
+
+        Flush();
+        WaitForValue(m_ring.OldestBatchValue().value_or(m_lastValue));
+        m_ring.Retire(CompletedValue());
+        offset = m_ring.TryAllocate(size, kAlignment);
+    }
+
+    return offset.value();
+}
+
+auto Uploader::CurrentCommandBuffer() -> VkCommandBuffer {
+    if (VK_NULL_HANDLE != m_recording) {
+        return m_recording;
+    }
+
+    // Reuse the command buffer of the oldest submission if it has finished, otherwise allocate another one.
+    if (!m_submissions.empty() && m_submissions.front().value <= CompletedValue()) {
+        m_recording = m_submissions.front().commandBuffer;
+        m_submissions.pop_front();
+        vkResetCommandBuffer(m_recording, 0);
+    } else {
+        const VkCommandBufferAllocateInfo allocInfo = { .sType              = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+                                                        .pNext              = nullptr,
+                                                        .commandPool        = m_commandPool,
+                                                        .level              = VK_COMMAND_BUFFER_LEVEL_PRIMARY,
+                                                        .commandBufferCount = 1 };
+
+        if (const auto& result = vkAllocateCommandBuffers(m_device, &allocInfo, &m_recording) != VK_SUCCESS) {
+            throw std::runtime_error(std::format("Uploader::CurrentCommandBuffer: Failed to allocate command buffer, error code: {}.", result));
+        }
+    }
+
+    const VkCommandBufferBeginInfo beginInfo = { .sType            = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+                                                 .pNext            = nullptr,
+                                                 .flags            = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT,
+                                                 .pInheritanceInfo = nullptr };
+
+    if (const auto& result = vkBeginCommandBuffer(m_recording, &beginInfo) != VK_SUCCESS) {
+        throw std::runtime_error(std::format("Uploader::CurrentCommandBuffer: Failed to begin command buffer, error code: {}.", result));
+    }
+
+    return m_recording;
+}
+
+auto Uploader::CompletedValue() const -> uint64_t {
+    uint64_t value = { 0 };
+    vkGetSemaphoreCounterValue(m_device, m_timeline, &value);
+    return value;
+}
+
+void Uploader::WaitForValue(uint64_t value) const {
+    const VkSemaphoreWaitInfo waitInfo = { .sType          = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO,
+                                           .pNext          = nullptr,
+                                           .flags          = {},
+                                           .semaphoreCount = 1,
+                                           .pSemaphores    = &m_timeline,
+                                           .pValues        = &value };
+
+    if (const auto& result = vkWaitSemaphores(m_device, &waitInfo, UINT64_MAX) != VK_SUCCESS) {
+        throw std::runtime_error(std::format("Uploader::WaitForValue: Failed to wait for the transfer timeline, error code: {}.", result));
+    }
+}
+
+}  // namespace vt::memory
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <span>
+#include <vector>
+
+#include "device_allocator.hpp"
+#include "staging_ring.hpp"
+
+namespace vt::memory {
+
+// Uploads to device local buffers through a persistently mapped staging ring, submitted on a transfer queue with a timeline semaphore.
+// The CPU never waits for an upload to finish, only for ring space when more than the ring's size is in flight.
+//
+// Buffers are created with VK_SHARING_MODE_EXCLUSIVE, so with a dedicated transfer queue family every upload is released by the transfer
+// queue and acquired by the graphics queue (RecordAcquire). Without one, the uploader submits to the graphics queue itself, the handover is then
+// a plain barrier. Either way the consuming submission waits for the timeline value returned by RecordAcquire.
+//
+// Not thread safe, all functions must be called from the thread that submits to the graphics queue, since the queue may be shared with it.
+class Uploader {
+  public:
+    struct Stats {
+        // NOLINTBEGIN(misc-non-private-member-variables-in-classes)
+        bool     dedicatedQueue = false;  // Whether uploads run on a queue family of their own.
+        uint64_t uploadedBytes  = 0;
+        uint64_t submissions    = 0;
+        uint64_t ringStalls     = 0;  // Times the CPU had to wait for staging ring space.
+        // NOLINTEND(misc-non-private-member-variables-in-classes)
+    };
+
+    // What the consuming submission must wait for before it touches the uploaded data.
+    struct Handover {
+        // NOLINTBEGIN(misc-non-private-member-variables-in-classes)
+        uint64_t              value     = 0;  // Transfer timeline value, 0 if there was nothing to hand over.
+        VkPipelineStageFlags2 stageMask = VK_PIPELINE_STAGE_2_NONE;
+        // NOLINTEND(misc-non-private-member-variables-in-classes)
+    };
+
+    static constexpr VkDeviceSize kDefaultRingSize = VkDeviceSize { 16 } * 1024 * 1024;
+
+    Uploader(VkDevice device, DeviceAllocator& allocator, VkQueue queue, uint32_t queueFamilyIndex, uint32_t graphicsFamilyIndex,
+             VkDeviceSize ringSize = kDefaultRingSize);
+    ~Uploader() noexcept;
+
+    // Copy constructor and assignment operator.
+    Uploader(const Uploader& other)                    = delete;
+    auto operator=(const Uploader& other) -> Uploader& = delete;
+
+    // Move constructor and move assignment operator.
+    Uploader(Uploader&& other) noexcept                    = delete;
+    auto operator=(Uploader&& other) noexcept -> Uploader& = delete;
+
+    // Copies 'data' into the ring and records its copy to 'dst'. Uploads larger than a quarter of the ring are split into chunks.
+    // 'dstStageMask' and 'dstAccessMask' describe the first use of the data on the graphics queue.
+    void Upload(VkBuffer dst, VkDeviceSize dstOffset, std::span<const std::byte> data, VkPipelineStageFlags2 dstStageMask, VkAccessFlags2 dstAccessMask);
+
+    // Submits everything uploaded since the last Flush, without waiting for it.
+    void Flush();
+
+    [[nodiscard]] auto HasPendingAcquires() const -> bool { return !m_acquires.empty(); }
+
+    // Records the graphics queue side of every flushed upload into 'commandBuffer', which must be submitted to the graphics queue.
+    auto RecordAcquire(VkCommandBuffer commandBuffer) -> Handover;
+
+    [[nodiscard]] auto GetTimeline() const -> VkSemaphore { return m_timeline; }
+    [[nodiscard]] auto GetStats() const -> const Stats& { return m_stats; }
+
+  private:
+    struct Submission {
+        // NOLINTBEGIN(misc-non-private-member-variables-in-classes)
+        VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+        uint64_t        value         = 0;
+        // NOLINTEND(misc-non-private-member-variables-in-classes)
+    };
+
+    static constexpr VkDeviceSize kAlignment = 16;
+
+    auto AllocateStaging(VkDeviceSize size) -> VkDeviceSize;
+    auto CurrentCommandBuffer() -> VkCommandBuffer;
+    auto CompletedValue() const -> uint64_t;
+    void WaitForValue(uint64_t value) const;
+
+    VkDevice         m_device              = VK_NULL_HANDLE;
+    DeviceAllocator& m_allocator;
+    VkQueue          m_queue               = VK_NULL_HANDLE;
+    uint32_t         m_queueFamilyIndex    = 0;
+    uint32_t         m_graphicsFamilyIndex = 0;
+    VkCommandPool    m_commandPool         = VK_NULL_HANDLE;
+    VkSemaphore      m_timeline            = VK_NULL_HANDLE;
+    uint64_t         m_lastValue           = 0;  // Value signaled by the last submission.
+
+    DeviceAllocator::Buffer m_ringBuffer;
+    StagingRing             m_ring;
+
+    VkCommandBuffer                     m_recording    = VK_NULL_HANDLE;  // Open command buffer of the current batch, if any.
+    std::deque<Submission>              m_submissions;                    // In flight, oldest first. Their command buffers are reused once retired.
+    std::vector<VkBufferMemoryBarrier2> m_releases;                       // Uploads of the current batch, in their acquire form.
+    std::vector<VkBufferMemoryBarrier2> m_acquires;                       // Flushed uploads not yet acquired by the graphics queue.
+    uint64_t                            m_acquireValue = 0;               // Timeline value the pending acquires must wait for.
+    Stats                               m_stats;
+};
+
+}  // namespace vt::memory
@@ -5,30 +5,37 @@
 #include <cstdint>
 #include <fstream>
 #include <iostream>
+#include <span>
 #include <stdexcept>
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace vt::utilities {
 
-static auto ReadBinaryFile(const std::string& filename) -> std::vector<char> {
+// Reads a SPIR-V binary into 32-bit words, which also gives the alignment vkCreateShaderModule requires.
+inline auto ReadSpirvFile(const std::string& filename) -> std::vector<uint32_t> {
     std::ifstream file(filename, std::ios::ate | std::ios::binary);
 
     if (!file.is_open()) {
-        throw std::runtime_error(std::format("Utilities::readBinaryFile: Failed to open file: [{}].", filename));
+        throw std::runtime_error(std::format("Utilities::ReadSpirvFile: Failed to open file: [{}].", filename));
     }
 
-    const size_t      fileSize = static_cast<size_t>(file.tellg());
-    std::vector<char> buffer(fileSize);
+    const size_t fileSize = static_cast<size_t>(file.tellg());
+    if (0 != fileSize % sizeof(uint32_t)) {
+        throw std::runtime_error(std::format("Utilities::ReadSpirvFile: [{}] is not a whole number of 32-bit words.", filename));
+    }
+
+    std::vector<uint32_t> buffer(fileSize / sizeof(uint32_t));
 
     file.seekg(0);
-    file.read(buffer.data(), static_cast<uint32_t>(fileSize));
+    file.read(reinterpret_cast<char*>(buffer.data()), static_cast<std::streamsize>(fileSize));
     file.close();
 
     return buffer;
 }
 
-static auto ChooseSwapSurfaceFormat(const std::vector<VkSurfaceFormatKHR>& availableFormats) -> VkSurfaceFormatKHR {
+inline auto ChooseSwapSurfaceFormat(const std::vector<VkSurfaceFormatKHR>& availableFormats) -> VkSurfaceFormatKHR {
     for (const auto& availableFormat : availableFormats) {
         if (availableFormat.format == VK_FORMAT_B8G8R8_SRGB && availableFormat.colorSpace == VK_COLOR_SPACE_SRGB_NONLINEAR_KHR) {
             return availableFormat;
@@ -40,10 +47,14 @@ static auto ChooseSwapSurfaceFormat(const std::vector<VkSurfaceFormatKHR>& avail
     return availableFormats[0];
 }
 
-static auto ChooseSwapPresentMode(const std::vector<VkPresentModeKHR>& availablePresentModes) -> VkPresentModeKHR {
-    for (const auto& availablePresentMode : availablePresentModes) {
-        if (availablePresentMode == VK_PRESENT_MODE_MAILBOX_KHR) {
-            return availablePresentMode;
+// Returns the first of 'preferredPresentModes' that is available, in order of preference.
+inline auto ChooseSwapPresentMode(const std::vector<VkPresentModeKHR>& availablePresentModes, std::span<const VkPresentModeKHR> preferredPresentModes)
+    -> VkPresentModeKHR {
+    for (const auto& preferredPresentMode : preferredPresentModes) {
+        for (const auto& availablePresentMode : availablePresentModes) {
+            if (availablePresentMode == preferredPresentMode) {
+                return availablePresentMode;
+            }
         }
     }
 
@@ -51,4 +62,14 @@ static auto ChooseSwapPresentMode(const std::vector<VkPresentModeKHR>& available
     return VK_PRESENT_MODE_FIFO_KHR;
 }
 
+inline auto PresentModeName(VkPresentModeKHR presentMode) -> std::string_view {
+    switch (presentMode) {
+        case VK_PRESENT_MODE_IMMEDIATE_KHR:    return "IMMEDIATE";
+        case VK_PRESENT_MODE_MAILBOX_KHR:      return "MAILBOX";
+        case VK_PRESENT_MODE_FIFO_KHR:         return "FIFO";
+        case VK_PRESENT_MODE_FIFO_RELAXED_KHR: return "FIFO_RELAXED";
+        default:                               return "other";
+    }
+}
+
 }  // namespace vt::utilities
@@ -0,0 +1,270 @@
+#include "validation_log.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <format>
+#include <iostream>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+
+#include "trace.hpp"
+
+namespace vt::validation {
+
+namespace {
+
+auto SeverityName(VkDebugUtilsMessageSeverityFlagBitsEXT severity) -> std::string_view {
+    switch (severity) {
+        case VK_DEBUG_UTILS_MESSAGE_SEVERITY_VERBOSE_BIT_EXT: return "Verbose";
+        case VK_DEBUG_UTILS_MESSAGE_SEVERITY_INFO_BIT_EXT:    return "Info";
+        case VK_DEBUG_UTILS_MESSAGE_SEVERITY_WARNING_BIT_EXT: return "Warning";
+        case VK_DEBUG_UTILS_MESSAGE_SEVERITY_ERROR_BIT_EXT:   return "Error";
+        default:                                              return "Invalid";
+    }
+}
+
+auto TypeNames(VkDebugUtilsMessageTypeFlagsEXT type) -> std::string {
+    static constexpr std::array<std::pair<VkDebugUtilsMessageTypeFlagBitsEXT, std::string_view>, 4> kTypeNames = {
+        { { VK_DEBUG_UTILS_MESSAGE_TYPE_GENERAL_BIT_EXT, "General" },
+          { VK_DEBUG_UTILS_MESSAGE_TYPE_VALIDATION_BIT_EXT, "Validation" },
+          { VK_DEBUG_UTILS_MESSAGE_TYPE_PERFORMANCE_BIT_EXT, "Performance" },
+          { VK_DEBUG_UTILS_MESSAGE_TYPE_DEVICE_ADDRESS_BINDING_BIT_EXT, "Device address binding" } }
+    };
+
+    std::string names = {};
+    for (const auto& [bit, name] : kTypeNames) {
+        if (0 != (type & static_cast<VkDebugUtilsMessageTypeFlagsEXT>(bit))) {
+            names += std::format("{}{}", names.empty() ? "" : ", ", name);
+        }
+    }
+
+    return names.empty() ? std::format("Invalid type code: {}", type) : names;
+}
+
+auto SteadyNanoseconds() -> int64_t {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+}  // namespace
+
+MessageLog::MessageLog(const Config& config)
+    : m_config(config), m_slots(std::make_unique<std::array<Slot, kCapacity>>()), m_messageIds(std::make_unique<std::array<MessageIdCount, kMessageIdSlots>>()) {
+    for (uint64_t i = 0; i < kCapacity; i++) {
+        (*m_slots)[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    m_thread = std::thread([this]() { LoggerLoop(); });
+}
+
+MessageLog::~MessageLog() noexcept {
+    Stop();
+}
+
+void MessageLog::Push(VkDebugUtilsMessageSeverityFlagBitsEXT severity, VkDebugUtilsMessageTypeFlagsEXT type, const VkDebugUtilsMessengerCallbackDataEXT& data) {
+    m_received.fetch_add(1, std::memory_order_relaxed);
+
+    if (severity < m_config.minSeverity || 0 == (type & m_config.types)) {
+        m_filtered.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    if (IsRepeat(data.messageIdNumber)) {
+        m_repeats.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    if (IsRateLimited(severity)) {
+        m_rateLimited.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    if (m_stopping.load(std::memory_order_relaxed) || !TryEnqueue(severity, type, data)) {
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    m_wakeups.fetch_add(1, std::memory_order_release);
+    m_wakeups.notify_one();
+}
+
+void MessageLog::Stop() {
+    if (!m_thread.joinable()) {
+        return;
+    }
+
+    m_stopping.store(true, std::memory_order_relaxed);
+    m_wakeups.fetch_add(1, std::memory_order_release);
+    m_wakeups.notify_one();
+    m_thread.join();
+
+    PrintRepeats();
+}
+
+auto MessageLog::GetStats() const -> Stats {
+    return { .received    = m_received.load(std::memory_order_relaxed),
+             .filtered    = m_filtered.load(std::memory_order_relaxed),
+             .repeats     = m_repeats.load(std::memory_order_relaxed),
+             .rateLimited = m_rateLimited.load(std::memory_order_relaxed),
+             .dropped     = m_dropped.load(std::memory_order_relaxed),
+             .logged      = m_logged.load(std::memory_order_relaxed) };
+}
+
+auto MessageLog::SeverityMask(VkDebugUtilsMessageSeverityFlagBitsEXT minSeverity) -> VkDebugUtilsMessageSeverityFlagsEXT {
+    // The severity bits are ordered, so every bit from 'minSeverity' up to and including the error bit.
+    const auto minBit   = static_cast<VkDebugUtilsMessageSeverityFlagsEXT>(minSeverity);
+    const auto errorBit = static_cast<VkDebugUtilsMessageSeverityFlagsEXT>(VK_DEBUG_UTILS_MESSAGE_SEVERITY_ERROR_BIT_EXT);
+    return (errorBit | (errorBit - 1)) & ~(minBit - 1);
+}
+
+auto MessageLog::IsRepeat(int32_t id) -> bool {
+    // Messages without an id, e.g. from the loader, can't be told apart without looking at the text, so they are never deduplicated.
+    if (0 == m_config.repeatLimit || 0 == id) {
+        return false;
+    }
+
+    const auto hash = static_cast<uint32_t>(id) * 2654435761U;
+    for (uint32_t probe = 0; probe < kMessageIdSlots; probe++) {
+        MessageIdCount& entry = (*m_messageIds)[(hash + probe) & (kMessageIdSlots - 1)];
+
+        int64_t current = entry.id.load(std::memory_order_acquire);
+        if (kNoMessageId == current && entry.id.compare_exchange_strong(current, id, std::memory_order_acq_rel)) {
+            current = id;
+        }
+
+        if (current == id) {
+            return entry.count.fetch_add(1, std::memory_order_relaxed) >= m_config.repeatLimit;
+        }
+    }
+
+    // Every slot holds another id, this one is printed each time rather than lost.
+    return false;
+}
+
+auto MessageLog::IsRateLimited(VkDebugUtilsMessageSeverityFlagBitsEXT severity) -> bool {
+    // Errors are never rate limited, so the first occurrence of each of them is always printed.
+    if (0 == m_config.messagesPerSecond || severity >= VK_DEBUG_UTILS_MESSAGE_SEVERITY_ERROR_BIT_EXT) {
+        return false;
+    }
+
+    constexpr int64_t kWindow = std::chrono::nanoseconds(std::chrono::seconds(1)).count();
+
+    const int64_t now         = SteadyNanoseconds();
+    int64_t       windowStart = m_rateWindowStart.load(std::memory_order_relaxed);
+    if (now - windowStart >= kWindow && m_rateWindowStart.compare_exchange_strong(windowStart, now, std::memory_order_relaxed)) {
+        m_rateWindowCount.store(0, std::memory_order_relaxed);
+    }
+
+    return m_rateWindowCount.fetch_add(1, std::memory_order_relaxed) >= m_config.messagesPerSecond;
+}
+
+auto MessageLog::TryEnqueue(VkDebugUtilsMessageSeverityFlagBitsEXT severity, VkDebugUtilsMessageTypeFlagsEXT type, const VkDebugUtilsMessengerCallbackDataEXT& data)
+    -> bool {
+    uint64_t position = m_writePosition.load(std::memory_order_relaxed);
+    Slot*    slot     = nullptr;
+    while (true) {
+        slot                    = &(*m_slots)[position & (kCapacity - 1)];
+        const uint64_t sequence = slot->sequence.load(std::memory_order_acquire);
+
+        if (sequence == position) {
+            if (m_writePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (sequence < position) {
+            return false;  // The slot still holds the message from one lap ago, the ring is full.
+        } else {
+            position = m_writePosition.load(std::memory_order_relaxed);
+        }
+    }
+
+    Message& message    = slot->message;
+    message.severity    = severity;
+    message.type        = type;
+    message.id          = data.messageIdNumber;
+    message.objectCount = data.objectCount;
+    message.length      = 0;
+
+    const std::span<const VkDebugUtilsObjectNameInfoEXT> objects = { data.pObjects, data.objectCount };
+    for (size_t i = 0; i < std::min<size_t>(objects.size(), kMaxObjects); i++) {
+        message.objects[i] = objects[i].objectHandle;
+    }
+
+    if (nullptr != data.pMessage) {
+        const char* end = std::find(data.pMessage, data.pMessage + kMaxMessageLength, '\0');
+        message.length  = static_cast<uint32_t>(end - data.pMessage);
+        std::memcpy(message.text.data(), data.pMessage, message.length);
+    }
+
+    slot->sequence.store(position + 1, std::memory_order_release);
+    return true;
+}
+
+auto MessageLog::Drain() -> uint64_t {
+    uint64_t count = 0;
+
+    while (true) {
+        Slot& slot = (*m_slots)[m_readPosition & (kCapacity - 1)];
+        if (slot.sequence.load(std::memory_order_acquire) != m_readPosition + 1) {
+            return count;
+        }
+
+        // Formatted here, on the logger thread, the same way the callback used to print it.
+        const Message& message = slot.message;
+        std::string    text    = "-----------------------------------------------\n";
+        text += std::format("Vulkan-Validation::debugCallback: \n{}\n\n", std::string_view(message.text.data(), message.length));
+        text += std::format("\tSeverity: {}\n", SeverityName(message.severity));
+        text += std::format("\tType: {}\n", TypeNames(message.type));
+        text += std::format("\tMessage id: {:#010x}\n", static_cast<uint32_t>(message.id));
+        text += "\tObjects: ";
+        for (uint32_t i = 0; i < std::min(message.objectCount, kMaxObjects); i++) {
+            text += std::format("{:x} ", message.objects[i]);
+        }
+        if (message.objectCount > kMaxObjects) {
+            text += std::format("(+{} more)", message.objectCount - kMaxObjects);
+        }
+        text += "\n\n";
+
+        // Hands the slot back to the producers one lap ahead.
+        slot.sequence.store(m_readPosition + kCapacity, std::memory_order_release);
+        m_readPosition++;
+
+        std::cerr << text;
+        m_logged.fetch_add(1, std::memory_order_relaxed);
+        count++;
+    }
+}
+
+void MessageLog::LoggerLoop() {
+    trace::SetThreadName("validation log");
+
+    while (true) {
+        const uint32_t wakeups = m_wakeups.load(std::memory_order_acquire);
+        Drain();
+
+        if (m_stopping.load(std::memory_order_relaxed)) {
+            return;
+        }
+
+        m_wakeups.wait(wakeups, std::memory_order_acquire);
+    }
+}
+
+void MessageLog::PrintRepeats() const {
+    for (const auto& entry : *m_messageIds) {
+        const int64_t  id    = entry.id.load(std::memory_order_relaxed);
+        const uint64_t count = entry.count.load(std::memory_order_relaxed);
+        if (kNoMessageId != id && count > m_config.repeatLimit) {
+            std::cerr << std::format("Vulkan-Validation: Message id {:#010x} repeated {} more time(s) after it was printed {} time(s).\n", static_cast<uint32_t>(id),
+                                     count - m_config.repeatLimit, m_config.repeatLimit);
+        }
+    }
+}
+
+}  // namespace vt::validation
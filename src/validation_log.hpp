@@ -0,0 +1,129 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <thread>
+
+namespace vt::validation {
+
+// Collects debug utils messages on whatever thread the driver or the validation layer calls back on, and prints them on a logger thread.
+// The callback side never locks, allocates or formats: messages are filtered by severity and type, deduplicated by their message id and
+// rate limited first, then copied into a fixed size lock-free ring. Whatever doesn't fit is dropped and counted instead of blocking the caller.
+class MessageLog {
+  public:
+    struct Config {
+        // NOLINTBEGIN(misc-non-private-member-variables-in-classes)
+        VkDebugUtilsMessageSeverityFlagBitsEXT minSeverity       = VK_DEBUG_UTILS_MESSAGE_SEVERITY_WARNING_BIT_EXT;
+        VkDebugUtilsMessageTypeFlagsEXT        types             = VK_DEBUG_UTILS_MESSAGE_TYPE_GENERAL_BIT_EXT | VK_DEBUG_UTILS_MESSAGE_TYPE_VALIDATION_BIT_EXT |
+                                                                   VK_DEBUG_UTILS_MESSAGE_TYPE_PERFORMANCE_BIT_EXT;
+        uint32_t                               repeatLimit       = 3;    // Occurrences of a message id that are printed, the rest is only counted. 0 prints all.
+        uint32_t                               messagesPerSecond = 100;  // Messages below error severity printed per second, 0 means no limit.
+        // NOLINTEND(misc-non-private-member-variables-in-classes)
+    };
+
+    struct Stats {
+        // NOLINTBEGIN(misc-non-private-member-variables-in-classes)
+        uint64_t received    = 0;  // Every callback, including the filtered ones.
+        uint64_t filtered    = 0;  // Below the minimum severity or of a type that isn't logged.
+        uint64_t repeats     = 0;  // Suppressed because their message id was already printed 'repeatLimit' times.
+        uint64_t rateLimited = 0;
+        uint64_t dropped     = 0;  // The ring was full, the logger thread fell behind.
+        uint64_t logged      = 0;
+        // NOLINTEND(misc-non-private-member-variables-in-classes)
+    };
+
+    explicit MessageLog(const Config& config);
+
+    // Stops the logger thread, see Stop.
+    ~MessageLog() noexcept;
+
+    // Copy constructor and assignment operator.
+    MessageLog(const MessageLog& other)                    = delete;
+    auto operator=(const MessageLog& other) -> MessageLog& = delete;
+
+    // Move constructor and move assignment operator.
+    MessageLog(MessageLog&& other) noexcept                    = delete;
+    auto operator=(MessageLog&& other) noexcept -> MessageLog& = delete;
+
+    // Called from the debug messenger callback, on any thread.
+    void Push(VkDebugUtilsMessageSeverityFlagBitsEXT severity, VkDebugUtilsMessageTypeFlagsEXT type, const VkDebugUtilsMessengerCallbackDataEXT& data);
+
+    // Prints everything still queued, then how often each suppressed message id repeated, and joins the logger thread.
+    // Messages pushed afterwards are counted as dropped.
+    void Stop();
+
+    [[nodiscard]] auto GetStats() const -> Stats;
+
+    // The severities a debug messenger has to report for 'minSeverity' and above, so the driver doesn't call back for filtered ones at all.
+    [[nodiscard]] static auto SeverityMask(VkDebugUtilsMessageSeverityFlagBitsEXT minSeverity) -> VkDebugUtilsMessageSeverityFlagsEXT;
+
+  private:
+    static constexpr uint32_t kCapacity         = 256;   // Ring slots, a power of two.
+    static constexpr uint32_t kMaxMessageLength = 2048;  // Longer messages are truncated.
+    static constexpr uint32_t kMaxObjects       = 8;
+    static constexpr uint32_t kMessageIdSlots   = 512;   // Distinct message ids tracked for deduplication, a power of two.
+    static constexpr int64_t  kNoMessageId      = std::numeric_limits<int64_t>::min();
+
+    struct Message {
+        // NOLINTBEGIN(misc-non-private-member-variables-in-classes)
+        VkDebugUtilsMessageSeverityFlagBitsEXT severity    = {};
+        VkDebugUtilsMessageTypeFlagsEXT        type        = {};
+        int32_t                                id          = 0;
+        uint32_t                               objectCount = 0;  // Of the callback, only the first kMaxObjects handles are kept.
+        std::array<uint64_t, kMaxObjects>      objects     = {};
+        uint32_t                               length      = 0;
+        std::array<char, kMaxMessageLength>    text        = {};
+        // NOLINTEND(misc-non-private-member-variables-in-classes)
+    };
+
+    // A bounded multi producer queue slot: 'sequence' equals the slot's write position when it is free and position + 1 once it holds a message.
+    struct Slot {
+        // NOLINTBEGIN(misc-non-private-member-variables-in-classes)
+        std::atomic<uint64_t> sequence = 0;
+        Message               message;
+        // NOLINTEND(misc-non-private-member-variables-in-classes)
+    };
+
+    // Open addressing table from message id to occurrence count, slots are claimed once and never freed.
+    struct MessageIdCount {
+        // NOLINTBEGIN(misc-non-private-member-variables-in-classes)
+        std::atomic<int64_t>  id    = kNoMessageId;
+        std::atomic<uint64_t> count = 0;
+        // NOLINTEND(misc-non-private-member-variables-in-classes)
+    };
+
+    auto IsRepeat(int32_t id) -> bool;
+    auto IsRateLimited(VkDebugUtilsMessageSeverityFlagBitsEXT severity) -> bool;
+    auto TryEnqueue(VkDebugUtilsMessageSeverityFlagBitsEXT severity, VkDebugUtilsMessageTypeFlagsEXT type, const VkDebugUtilsMessengerCallbackDataEXT& data) -> bool;
+    auto Drain() -> uint64_t;
+    void LoggerLoop();
+    void PrintRepeats() const;
+
+    Config m_config;
+
+    std::unique_ptr<std::array<Slot, kCapacity>>                 m_slots;
+    std::atomic<uint64_t>                                        m_writePosition = 0;
+    uint64_t                                                     m_readPosition  = 0;  // Only used by the logger thread.
+    std::unique_ptr<std::array<MessageIdCount, kMessageIdSlots>> m_messageIds;
+
+    std::atomic<int64_t>  m_rateWindowStart = 0;  // steady_clock nanoseconds.
+    std::atomic<uint32_t> m_rateWindowCount = 0;
+
+    std::atomic<uint64_t> m_received    = 0;
+    std::atomic<uint64_t> m_filtered    = 0;
+    std::atomic<uint64_t> m_repeats     = 0;
+    std::atomic<uint64_t> m_rateLimited = 0;
+    std::atomic<uint64_t> m_dropped     = 0;
+    std::atomic<uint64_t> m_logged      = 0;
+
+    std::atomic<uint32_t> m_wakeups  = 0;  // Bumped after every enqueue, the logger thread waits on it while the ring is empty.
+    std::atomic<bool>     m_stopping = false;
+    std::thread           m_thread;
+};
+
+}  // namespace vt::validation
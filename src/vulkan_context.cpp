@@ -0,0 +1,69 @@
+#include "vulkan_context.hpp"
+
+#include <cstdint>
+#include <format>
+#include <functional>
+#include <iostream>
+#include <mutex>
+#include <optional>
+#include <utility>
+
+#include "vulkan_validation.hpp"
+
+namespace vt::triangle {
+
+VulkanContext::~VulkanContext() noexcept {
+    if (m_device.has_value()) {
+        vkDestroyDevice(m_device->device, nullptr);
+    }
+
+    if (!m_instance.has_value()) {
+        return;
+    }
+
+    if (VK_NULL_HANDLE != m_instance->debugMessenger) {
+        validation::DestroyDebugUtilsMessengerEXT(m_instance->instance, m_instance->debugMessenger, nullptr);
+    }
+
+    vkDestroyInstance(m_instance->instance, nullptr);
+
+    // After the instance, which reports its own destruction through the same log.
+    if (nullptr != m_instance->validationLog) {
+        m_instance->validationLog->Stop();
+
+        const auto stats = m_instance->validationLog->GetStats();
+        std::cout << std::format("{}::~VulkanContext: {} validation message(s), {} printed, {} filtered, {} repeat(s) and {} over the rate limit suppressed, {} dropped.\n",
+                                 kClassName, stats.received, stats.logged, stats.filtered, stats.repeats, stats.rateLimited, stats.dropped);
+    }
+}
+
+auto VulkanContext::GetInstance(const std::function<Instance()>& create) -> VkInstance {
+    const std::scoped_lock lock(m_mutex);
+
+    if (!m_instance.has_value()) {
+        m_instance = create();
+    }
+
+    return m_instance->instance;
+}
+
+auto VulkanContext::AcquireSharedDevice(const std::function<Device()>& create) -> std::optional<std::pair<Device, uint32_t>> {
+    if (!m_shareDevice) {
+        return std::nullopt;
+    }
+
+    const std::scoped_lock lock(m_mutex);
+
+    if (!m_device.has_value()) {
+        m_device = create();
+    }
+
+    // A VkQueue may only be used by one thread at a time, so a renderer without a queue of its own can't use the shared device.
+    if (m_nextQueueIndex >= m_device->queueCount) {
+        return std::nullopt;
+    }
+
+    return std::make_pair(m_device.value(), m_nextQueueIndex++);
+}
+
+}  // namespace vt::triangle
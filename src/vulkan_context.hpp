@@ -0,0 +1,74 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <utility>
+
+#include "validation_log.hpp"
+
+namespace vt::triangle {
+
+// The Vulkan objects that several renderers in one process share: always the instance, and with 'shareDevice' the logical device too.
+// Whichever renderer initializes first creates them through the function it passes in, the others reuse them. Every renderer that uses
+// the context keeps it alive through a shared_ptr, so the shared objects are destroyed once the last of them has cleaned up.
+class VulkanContext {
+  public:
+    struct Instance {
+        // NOLINTBEGIN(misc-non-private-member-variables-in-classes)
+        VkInstance                              instance       = VK_NULL_HANDLE;
+        VkDebugUtilsMessengerEXT                debugMessenger = VK_NULL_HANDLE;  // Only with validation layers.
+        std::unique_ptr<validation::MessageLog> validationLog;                    // Only with validation layers.
+        // NOLINTEND(misc-non-private-member-variables-in-classes)
+    };
+
+    struct Device {
+        // NOLINTBEGIN(misc-non-private-member-variables-in-classes)
+        VkPhysicalDevice physicalDevice   = VK_NULL_HANDLE;
+        VkDevice         device           = VK_NULL_HANDLE;
+        uint32_t         queueCount       = 1;  // Queues created in each queue family the device uses, every renderer gets its own index.
+        bool             dynamicRendering = false;
+        // NOLINTEND(misc-non-private-member-variables-in-classes)
+    };
+
+    VulkanContext(uint32_t rendererCount, bool shareDevice) : m_rendererCount(rendererCount), m_shareDevice(shareDevice) {}
+
+    // Destroys the shared device, the debug messenger and the instance. Every renderer must have destroyed its own objects by then.
+    ~VulkanContext() noexcept;
+
+    // Copy constructor and assignment operator.
+    VulkanContext(const VulkanContext& other)                    = delete;
+    auto operator=(const VulkanContext& other) -> VulkanContext& = delete;
+
+    // Move constructor and move assignment operator.
+    VulkanContext(VulkanContext&& other) noexcept                    = delete;
+    auto operator=(VulkanContext&& other) noexcept -> VulkanContext& = delete;
+
+    [[nodiscard]] auto GetRendererCount() const -> uint32_t { return m_rendererCount; }
+    [[nodiscard]] auto SharesDevice() const -> bool { return m_shareDevice; }
+
+    // Returns the instance, the first caller creates it with 'create'. Thread-safe.
+    auto GetInstance(const std::function<Instance()>& create) -> VkInstance;
+
+    // Returns the shared device and the queue index reserved for the caller, the first caller creates the device with 'create', which should
+    // ask for 'GetRendererCount' queues per family. Returns nullopt once every queue has been handed out, or without 'shareDevice'. Thread-safe.
+    auto AcquireSharedDevice(const std::function<Device()>& create) -> std::optional<std::pair<Device, uint32_t>>;
+
+  private:
+    const std::string kClassName = "VulkanContext";  // NOLINT(readability-identifier-naming)
+
+    uint32_t m_rendererCount = 1;
+    bool     m_shareDevice   = true;
+
+    std::mutex              m_mutex;
+    std::optional<Instance> m_instance;
+    std::optional<Device>   m_device;
+    uint32_t                m_nextQueueIndex = 0;
+};
+
+}  // namespace vt::triangle
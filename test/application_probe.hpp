@@ -0,0 +1,83 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include <cstdint>
+#include <string>
+
+#include "hello_triangle_application.hpp"
+
+namespace vt::test {
+
+// Calls the private steps of HelloTriangleApplication that the benchmarks measure in isolation. Every call expects an initialized
+// application with no frame in flight, except DrawFrame which is public and keeps its own frames in order.
+struct ApplicationProbe {
+    using Application = triangle::HelloTriangleApplication;
+
+    // Records the frame's command buffer for 'imageIndex' the way DrawFrame does, without submitting it.
+    static void RecordCommandBuffer(Application& app, uint32_t imageIndex) {
+        const VkCommandBuffer commandBuffer = app.m_frames.front().commandBuffer;
+
+        app.m_framePipeline = app.SelectGraphicsPipeline();
+        vkResetCommandBuffer(commandBuffer, /*VkCommandBufferResetFlagBits*/ 0);
+        app.RecordCommandBuffer(commandBuffer, imageIndex);
+    }
+
+    // Destroys the graphics pipeline and creates it again, the same steps a swap chain format change takes.
+    // With 'coldCache' the pipeline cache is replaced by an empty one first, otherwise it still holds the previous build.
+    static void RecreateGraphicsPipeline(Application& app, bool coldCache) {
+        app.m_pipelineVariants.reset();
+        vkDestroyPipeline(app.m_device, app.m_graphicsPipeline, nullptr);
+        vkDestroyPipelineLayout(app.m_device, app.m_pipelineLayout, nullptr);
+
+        if (coldCache) {
+            vkDestroyPipelineCache(app.m_device, app.m_pipelineCache, nullptr);
+            app.CreatePipelineCache();
+        }
+
+        app.CreateGraphicsPipeline();
+    }
+
+    static void PickPhysicalDevice(Application& app) { app.PickPhysicalDevice(); }
+
+    [[nodiscard]] static auto GetDeviceName(const Application& app) -> std::string {
+        VkPhysicalDeviceProperties properties = {};
+        vkGetPhysicalDeviceProperties(app.m_physicalDevice, &properties);
+        return properties.deviceName;
+    }
+};
+
+// A headless application, initialized on construction and cleaned up on destruction. The pipeline cache isn't read
+// or written, so a run neither depends on nor changes the state left by earlier runs.
+class ApplicationFixture {
+  public:
+    explicit ApplicationFixture(triangle::HelloTriangleApplication::Settings settings) : m_application(WithBenchmarkDefaults(settings)) {
+        m_application.Initialize();
+    }
+
+    ~ApplicationFixture() noexcept {
+        m_application.WaitIdle();
+        m_application.Cleanup();
+    }
+
+    // Copy constructor and assignment operator.
+    ApplicationFixture(const ApplicationFixture& other)                    = delete;
+    auto operator=(const ApplicationFixture& other) -> ApplicationFixture& = delete;
+
+    // Move constructor and move assignment operator.
+    ApplicationFixture(ApplicationFixture&& other) noexcept                    = delete;
+    auto operator=(ApplicationFixture&& other) noexcept -> ApplicationFixture& = delete;
+
+    [[nodiscard]] auto Get() -> triangle::HelloTriangleApplication& { return m_application; }
+
+  private:
+    static auto WithBenchmarkDefaults(triangle::HelloTriangleApplication::Settings settings) -> triangle::HelloTriangleApplication::Settings {
+        settings.headless          = true;
+        settings.pipelineCachePath = {};
+        return settings;
+    }
+
+    triangle::HelloTriangleApplication m_application;
+};
+
+}  // namespace vt::test
@@ -0,0 +1,204 @@
+#include "benchmark_baseline.hpp"
+
+#include <cctype>
+#include <charconv>
+#include <cstddef>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <iterator>
+#include <optional>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace vt::test {
+
+namespace {
+
+auto Escape(std::string_view text) -> std::string {
+    std::string escaped;
+    escaped.reserve(text.size());
+
+    for (const char character : text) {
+        if ('"' == character || '\\' == character) {
+            escaped.push_back('\\');
+        }
+        escaped.push_back(character);
+    }
+
+    return escaped;
+}
+
+// Reads exactly the JSON SaveBaseline writes, an object with a "device" string and a "benchmarks" object of numbers, in any order and spacing.
+class BaselineReader {
+  public:
+    BaselineReader(std::string text, const std::filesystem::path& path) : m_text(std::move(text)), m_path(path.string()) {}
+
+    auto Read() -> Baseline {
+        Baseline baseline = {};
+
+        Expect('{');
+        ReadMembers([&](const std::string& key) {
+            if ("device" == key) {
+                baseline.device = ReadString();
+            } else if ("benchmarks" == key) {
+                Expect('{');
+                ReadMembers([&](const std::string& name) { baseline.meanNs[name] = ReadNumber(); });
+            } else {
+                throw Error(std::format("unknown key '{}'", key));
+            }
+        });
+
+        SkipSpace();
+        if (m_position != m_text.size()) {
+            throw Error("trailing characters");
+        }
+
+        return baseline;
+    }
+
+  private:
+    // Reads '"key": value' pairs up to and including the closing brace, the opening brace has already been read.
+    template <typename ReadValue>
+    void ReadMembers(ReadValue&& readValue) {
+        if (Accept('}')) {
+            return;
+        }
+
+        do {
+            const std::string key = ReadString();
+            Expect(':');
+            readValue(key);
+        } while (Accept(','));
+
+        Expect('}');
+    }
+
+    auto ReadString() -> std::string {
+        Expect('"');
+
+        std::string text;
+        while (m_position < m_text.size() && '"' != m_text[m_position]) {
+            if ('\\' == m_text[m_position]) {
+                m_position++;
+            }
+            if (m_position < m_text.size()) {
+                text.push_back(m_text[m_position++]);
+            }
+        }
+
+        Expect('"');
+        return text;
+    }
+
+    auto ReadNumber() -> double {
+        SkipSpace();
+
+        double      value  = 0.0;
+        const char* begin  = m_text.data() + m_position;
+        const auto  result = std::from_chars(begin, m_text.data() + m_text.size(), value);
+        if (result.ec != std::errc {}) {
+            throw Error("expected a number");
+        }
+
+        m_position += static_cast<size_t>(result.ptr - begin);
+        return value;
+    }
+
+    void SkipSpace() {
+        while (m_position < m_text.size() && 0 != std::isspace(static_cast<unsigned char>(m_text[m_position]))) {
+            m_position++;
+        }
+    }
+
+    auto Accept(char character) -> bool {
+        SkipSpace();
+        if (m_position < m_text.size() && character == m_text[m_position]) {
+            m_position++;
+            return true;
+        }
+
+        return false;
+    }
+
+    void Expect(char character) {
+        if (!Accept(character)) {
+            throw Error(std::format("expected '{}'", character));
+        }
+    }
+
+    [[nodiscard]] auto Error(std::string_view message) const -> std::runtime_error {
+        return std::runtime_error(std::format("Baseline::LoadBaseline: Malformed baseline [{}] at offset {}: {}.", m_path, m_position, message));
+    }
+
+    std::string m_text;
+    std::string m_path;
+    size_t      m_position = 0;
+};
+
+}  // namespace
+
+auto CurrentRun() -> Baseline& {
+    static Baseline run;
+    return run;
+}
+
+auto LoadBaseline(const std::filesystem::path& path) -> std::optional<Baseline> {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        return std::nullopt;
+    }
+
+    std::string text(std::istreambuf_iterator<char>(file), {});
+    return BaselineReader(std::move(text), path).Read();
+}
+
+void SaveBaseline(const std::filesystem::path& path, const Baseline& baseline) {
+    std::ostringstream json;
+    json << "{\n";
+    json << std::format("    \"device\": \"{}\",\n", Escape(baseline.device));
+    json << "    \"benchmarks\": {";
+
+    const char* separator = "\n";
+    for (const auto& [name, meanNs] : baseline.meanNs) {
+        json << std::format("{}        \"{}\": {:.1f}", separator, Escape(name), meanNs);
+        separator = ",\n";
+    }
+    json << "\n    }\n}\n";
+
+    const std::filesystem::path tempPath = std::filesystem::path(path) += ".tmp";
+    {
+        std::ofstream file(tempPath, std::ios::trunc);
+        if (!file.is_open()) {
+            throw std::runtime_error(std::format("Baseline::SaveBaseline: Failed to open file: [{}].", tempPath.string()));
+        }
+
+        file << json.str();
+        file.flush();
+
+        if (!file) {
+            throw std::runtime_error(std::format("Baseline::SaveBaseline: Failed to write file: [{}].", tempPath.string()));
+        }
+    }
+
+    std::filesystem::rename(tempPath, path);
+}
+
+auto FindRegressions(const Baseline& baseline, const Baseline& results, double tolerance) -> std::vector<Regression> {
+    std::vector<Regression> regressions;
+
+    for (const auto& [name, meanNs] : results.meanNs) {
+        const auto entry = baseline.meanNs.find(name);
+        if (entry != baseline.meanNs.end() && meanNs > entry->second * (1.0 + tolerance)) {
+            regressions.push_back({ .name = name, .baselineNs = entry->second, .meanNs = meanNs });
+        }
+    }
+
+    return regressions;
+}
+
+}  // namespace vt::test
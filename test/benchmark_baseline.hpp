@@ -0,0 +1,39 @@
+#pragma once
+
+#include <filesystem>
+#include <map>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace vt::test {
+
+// Mean time of every benchmark of one run, and the Vulkan device it ran on. Times are only comparable between runs on the same device.
+struct Baseline {
+    // NOLINTBEGIN(misc-non-private-member-variables-in-classes)
+    std::string                   device;
+    std::map<std::string, double> meanNs;  // By benchmark name.
+    // NOLINTEND(misc-non-private-member-variables-in-classes)
+};
+
+struct Regression {
+    // NOLINTBEGIN(misc-non-private-member-variables-in-classes)
+    std::string name;
+    double      baselineNs = 0.0;
+    double      meanNs     = 0.0;
+    // NOLINTEND(misc-non-private-member-variables-in-classes)
+};
+
+// The results of the running benchmark session, filled in by the benchmark listener and the fixtures.
+auto CurrentRun() -> Baseline&;
+
+// Returns std::nullopt if the file doesn't exist, throws if it exists but isn't a baseline written by SaveBaseline.
+auto LoadBaseline(const std::filesystem::path& path) -> std::optional<Baseline>;
+
+// Writes to a temporary file next to 'path' and renames it into place, so an interrupted run never leaves a partial baseline behind.
+void SaveBaseline(const std::filesystem::path& path, const Baseline& baseline);
+
+// Benchmarks whose mean exceeds their baseline mean by more than 'tolerance', a fraction of the baseline. Benchmarks missing from either side are skipped.
+auto FindRegressions(const Baseline& baseline, const Baseline& results, double tolerance) -> std::vector<Regression>;
+
+}  // namespace vt::test
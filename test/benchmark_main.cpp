@@ -0,0 +1,106 @@
+#include <catch2/benchmark/detail/catch_benchmark_stats.hpp>
+#include <catch2/catch_session.hpp>
+#include <catch2/reporters/catch_reporter_event_listener.hpp>
+#include <catch2/reporters/catch_reporter_registrars.hpp>
+
+#include <cstdlib>
+#include <exception>
+#include <format>
+#include <iostream>
+#include <string>
+
+#include "benchmark_baseline.hpp"
+
+namespace {
+
+// Collects the mean of every finished benchmark into vt::test::CurrentRun.
+class BaselineListener : public Catch::EventListenerBase {
+  public:
+    using Catch::EventListenerBase::EventListenerBase;
+
+    void benchmarkEnded(const Catch::BenchmarkStats<>& stats) override { vt::test::CurrentRun().meanNs[stats.info.name] = stats.mean.point.count(); }
+};
+
+// Returned when there is no baseline to compare with, ctest reports the run as skipped rather than passed.
+constexpr int kExitSkipped = 4;
+
+// Compares the run with the baseline, or records it as the new baseline when 'update' is set. A missing baseline is only ever
+// written by an update, otherwise a fresh checkout would record its own baseline and pass every time.
+// An update keeps the entries of benchmarks that didn't run, so a filtered run only replaces its own.
+auto CheckBaseline(const std::string& path, bool update, double tolerance) -> int {
+    const auto& run      = vt::test::CurrentRun();
+    const auto  baseline = vt::test::LoadBaseline(path);
+
+    if (!update && !baseline.has_value()) {
+        std::cerr << std::format("Baseline: [{}] doesn't exist, nothing was compared. Record it with --update-baseline.\n", path);
+        return kExitSkipped;
+    }
+
+    if (update) {
+        auto updated = baseline.has_value() && baseline->device == run.device ? baseline.value() : vt::test::Baseline { .device = run.device, .meanNs = {} };
+        for (const auto& [name, meanNs] : run.meanNs) {
+            updated.meanNs[name] = meanNs;
+        }
+
+        vt::test::SaveBaseline(path, updated);
+        std::cout << std::format("Baseline: Recorded {} benchmark(s) on '{}' in the baseline [{}].\n", run.meanNs.size(), run.device, path);
+        return EXIT_SUCCESS;
+    }
+
+    // A baseline from another device says nothing about this one, e.g. a developer GPU against the software device in CI.
+    if (baseline->device != run.device) {
+        std::cout << std::format("Baseline: [{}] was recorded on '{}', not compared with '{}'.\n", path, baseline->device, run.device);
+        return EXIT_SUCCESS;
+    }
+
+    const auto regressions = vt::test::FindRegressions(baseline.value(), run, tolerance);
+    for (const auto& regression : regressions) {
+        std::cout << std::format("Baseline: '{}' regressed from {:.1f} us to {:.1f} us (+{:.0f}%, tolerance {:.0f}%).\n", regression.name,
+                                 regression.baselineNs / 1000.0, regression.meanNs / 1000.0, ((regression.meanNs / regression.baselineNs) - 1.0) * 100.0,
+                                 tolerance * 100.0);
+    }
+
+    for (const auto& [name, meanNs] : run.meanNs) {
+        if (!baseline->meanNs.contains(name)) {
+            std::cout << std::format("Baseline: '{}' has no baseline yet, run with --update-baseline to add it.\n", name);
+        }
+    }
+
+    std::cout << std::format("Baseline: {} of {} benchmark(s) regressed against [{}].\n", regressions.size(), run.meanNs.size(), path);
+    return regressions.empty() ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+}  // namespace
+
+CATCH_REGISTER_LISTENER(BaselineListener)
+
+auto main(int argc, char* argv[]) -> int {
+    Catch::Session session;
+
+    std::string baselinePath   = {};
+    bool        updateBaseline = false;
+    double      tolerance      = 0.25;
+
+    using Catch::Clara::Opt;
+    session.cli(session.cli() | Opt(baselinePath, "path")["--baseline"]("compare the benchmark means with this baseline, the run is skipped if it doesn't exist") |
+                Opt(updateBaseline)["--update-baseline"]("record this run as the new baseline instead of comparing with it") |
+                Opt(tolerance, "fraction")["--tolerance"]("slowdown of a benchmark mean relative to its baseline that fails the run (default: 0.25)"));
+
+    if (const int result = session.applyCommandLine(argc, argv); 0 != result) {
+        return result;
+    }
+
+    const int result = session.run();
+
+    // Listing the tests, or a filter matching no benchmark, leaves nothing to compare.
+    if (0 != result || baselinePath.empty() || vt::test::CurrentRun().meanNs.empty()) {
+        return result;
+    }
+
+    try {
+        return CheckBaseline(baselinePath, updateBaseline, tolerance);
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << '\n';
+        return EXIT_FAILURE;
+    }
+}
@@ -0,0 +1,133 @@
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <streambuf>
+#include <vector>
+
+#include "application_probe.hpp"
+#include "benchmark_baseline.hpp"
+#include "geometry.hpp"
+#include "utilities.hpp"
+
+namespace {
+
+using Application = vt::triangle::HelloTriangleApplication;
+using Probe       = vt::test::ApplicationProbe;
+
+// Discards std::cout while it lives. Some of the measured steps report to std::cout, printing that on every iteration would flood the
+// benchmark report, the formatting itself is still measured.
+class SilenceOutput {
+  public:
+    SilenceOutput() : m_buffer(std::cout.rdbuf(nullptr)) {}
+    ~SilenceOutput() noexcept { std::cout.rdbuf(m_buffer); }
+
+    // Copy constructor and assignment operator.
+    SilenceOutput(const SilenceOutput& other)                    = delete;
+    auto operator=(const SilenceOutput& other) -> SilenceOutput& = delete;
+
+    // Move constructor and move assignment operator.
+    SilenceOutput(SilenceOutput&& other) noexcept                    = delete;
+    auto operator=(SilenceOutput&& other) noexcept -> SilenceOutput& = delete;
+
+  private:
+    std::streambuf* m_buffer = nullptr;
+};
+
+void RecordDevice(const Application& app) { vt::test::CurrentRun().device = Probe::GetDeviceName(app); }
+
+}  // namespace
+
+TEST_CASE("RecordCommandBuffer", "[benchmark][record]") {
+    const uint32_t drawCount = GENERATE(1U, 1000U);
+
+    Application::Settings settings = {};
+    settings.drawCount             = drawCount;
+
+    vt::test::ApplicationFixture fixture(settings);
+    RecordDevice(fixture.Get());
+
+    BENCHMARK(std::format("RecordCommandBuffer, {} draw(s)", drawCount)) { Probe::RecordCommandBuffer(fixture.Get(), 0); };
+}
+
+TEST_CASE("RecordCommandBuffer with CPU culling", "[benchmark][record]") {
+    Application::Settings settings = {};
+    settings.culling               = Application::CullingMode::CPU;
+    settings.instanceCount         = 100000;
+    settings.viewZoom              = 4.0F;
+
+    vt::test::ApplicationFixture fixture(settings);
+    RecordDevice(fixture.Get());
+
+    BENCHMARK("RecordCommandBuffer, CPU culling of 100000 objects") { Probe::RecordCommandBuffer(fixture.Get(), 0); };
+}
+
+// Headless, so the frame ends at the submit: presenting needs a window and a display, which the CI runner doesn't have.
+// A static scene skips the recording, which leaves the frame slot wait, the upload flush and the submit.
+TEST_CASE("DrawFrame", "[benchmark][frame]") {
+    const bool staticScene = GENERATE(false, true);
+
+    Application::Settings settings = {};
+    settings.staticScene           = staticScene;
+
+    vt::test::ApplicationFixture fixture(settings);
+    RecordDevice(fixture.Get());
+
+    BENCHMARK(std::format("DrawFrame, {}", staticScene ? "static scene" : "recorded")) { fixture.Get().DrawFrame(); };
+}
+
+TEST_CASE("CreateGraphicsPipeline", "[benchmark][pipeline]") {
+    const bool coldCache = GENERATE(true, false);
+
+    vt::test::ApplicationFixture fixture(Application::Settings {});
+    RecordDevice(fixture.Get());
+
+    BENCHMARK_ADVANCED(std::format("CreateGraphicsPipeline, {} pipeline cache", coldCache ? "cold" : "warm"))(Catch::Benchmark::Chronometer meter) {
+        const SilenceOutput silence;
+        meter.measure([&]() { Probe::RecreateGraphicsPipeline(fixture.Get(), coldCache); });
+    };
+}
+
+TEST_CASE("PickPhysicalDevice", "[benchmark][device]") {
+    vt::test::ApplicationFixture fixture(Application::Settings {});
+    RecordDevice(fixture.Get());
+
+    BENCHMARK_ADVANCED("PickPhysicalDevice")(Catch::Benchmark::Chronometer meter) {
+        const SilenceOutput silence;
+        meter.measure([&]() { Probe::PickPhysicalDevice(fixture.Get()); });
+    };
+}
+
+// The sort runs once per instance buffer upload, the copy of the unsorted grid is part of every iteration.
+TEST_CASE("SortByDepth", "[benchmark][geometry]") {
+    const auto grid = vt::geometry::MakeInstanceGrid(100000, 1.0F);
+
+    BENCHMARK("SortByDepth, 100000 instances") {
+        auto instances = grid;
+        vt::geometry::SortByDepth(instances, true);
+        return instances;
+    };
+}
+
+// A file the size of a small shader module, read from the page cache after the first iteration like shaders during development.
+TEST_CASE("ReadSpirvFile", "[benchmark][io]") {
+    constexpr size_t kWordCount = 4096;
+
+    const auto path = std::filesystem::temp_directory_path() / "vulkan-triangle-microbench.spv";
+    {
+        const std::vector<uint32_t> words(kWordCount, 0x07230203);  // The SPIR-V magic number.
+        std::ofstream               file(path, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(words.data()), static_cast<std::streamsize>(words.size() * sizeof(uint32_t)));
+        REQUIRE(file.good());
+    }
+
+    BENCHMARK("ReadSpirvFile, 16 KiB") { return vt::utilities::ReadSpirvFile(path.string()); };
+
+    std::filesystem::remove(path);
+}